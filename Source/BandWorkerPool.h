@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    BandWorkerPool.h
+    Created: 17 Oct 2026 3:52:08am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "RealtimeAudit.h"
+
+/*
+    Small pre-spawned pool used to run independent per-band work from
+    processBlock. Dispatch and join are plain atomics: the calling thread
+    publishes a job, takes a share of it itself and spins until the workers
+    have finished theirs.
+
+    Workers spin for a short while after each job so back-to-back blocks
+    find them awake. After that they park on a WaitableEvent, and the next
+    dispatch has to signal it, which may take a lock. That is fine offline
+    but is why the processor only uses this pool for realtime playback when
+    it is told to.
+*/
+class BandWorkerPool
+{
+public:
+    explicit BandWorkerPool (int numWorkersToUse)
+    {
+        for (int i = 0; i < numWorkersToUse; ++i)
+            workers.add(new Worker(*this, i));
+
+        for (auto* worker : workers)
+            worker->startThread(8);
+    }
+
+    ~BandWorkerPool()
+    {
+        for (auto* worker : workers)
+        {
+            worker->signalThreadShouldExit();
+            worker->wakeUp.signal();
+        }
+
+        for (auto* worker : workers)
+            worker->stopThread(1000);
+    }
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    /** Calls fn(i) for every i in [0, numTasks) across the pool and the
+        calling thread, and returns once all of them are done.
+        Never allocates; fn only has to outlive the call.
+    */
+    template <typename Fn>
+    void run (size_t numTasks, Fn& fn) noexcept
+    {
+        jassert(numTasks <= indexMask);
+
+        if (numTasks == 0)
+            return;
+
+        task = [](void* context, size_t index) { (*static_cast<Fn*>(context))(index); };
+        taskContext = &fn;
+        remaining.store(numTasks, std::memory_order_relaxed);
+
+        generation = (generation + 1) & 0xffffffff;
+        job.store((generation << 32) | (static_cast<juce::uint64>(numTasks) << 16));
+
+        for (auto* worker : workers)
+            if (worker->parked.load())
+                worker->wakeUp.signal();
+
+        runTasks();
+
+        for (int spins = 0; remaining.load(std::memory_order_acquire) != 0; ++spins)
+            backOff(spins);
+    }
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker (BandWorkerPool& p, int index)
+            : juce::Thread("Band worker " + juce::String(index)), pool(p)
+        {
+        }
+
+        void run() override
+        {
+            auto lastGeneration = getGeneration(pool.job.load());
+
+            while (! threadShouldExit())
+            {
+                if (waitForJob(lastGeneration))
+                {
+                    lastGeneration = getGeneration(pool.job.load());
+
+                    // The tasks are audio thread work, and run with the same
+                    // flush-to-zero setting and audit as processBlock.
+                    RealtimeAudit::ScopedAudioThread audioThread (false);
+                    juce::ScopedNoDenormals noDenormals;
+                    pool.runTasks();
+                }
+            }
+        }
+
+        juce::WaitableEvent wakeUp;
+        std::atomic<bool> parked { false };
+
+    private:
+        // Returns true once a new job has been published.
+        bool waitForJob (juce::uint64 lastGeneration)
+        {
+            for (int spins = 0; spins < spinsBeforeParking; ++spins)
+            {
+                if (getGeneration(pool.job.load(std::memory_order_acquire)) != lastGeneration)
+                    return true;
+
+                backOff(spins);
+            }
+
+            // seq_cst on both sides: either run() sees parked, or we see its job.
+            parked.store(true);
+
+            if (getGeneration(pool.job.load()) == lastGeneration && ! threadShouldExit())
+                wakeUp.wait(10);
+
+            parked.store(false);
+
+            return getGeneration(pool.job.load()) != lastGeneration;
+        }
+
+        BandWorkerPool& pool;
+    };
+
+    // job packs the generation (32 bits), task count (16 bits) and next task
+    // index (16 bits) into one word, so claiming a task can never pair an
+    // index with another job's count.
+    static constexpr juce::uint64 indexMask = 0xffff;
+
+    static juce::uint64 getGeneration (juce::uint64 j) noexcept { return j >> 32; }
+    static size_t getCount (juce::uint64 j) noexcept            { return static_cast<size_t>((j >> 16) & indexMask); }
+    static size_t getIndex (juce::uint64 j) noexcept            { return static_cast<size_t>(j & indexMask); }
+
+    static void backOff (int spins) noexcept
+    {
+        if (spins > 64)
+            std::this_thread::yield();
+    }
+
+    void runTasks() noexcept
+    {
+        auto j = job.load(std::memory_order_acquire);
+
+        while (getIndex(j) < getCount(j))
+        {
+            if (job.compare_exchange_weak(j, j + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                // A claimed task keeps run() waiting, so task and taskContext are stable here.
+                task(taskContext, getIndex(j));
+                remaining.fetch_sub(1, std::memory_order_release);
+                j = job.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    static constexpr int spinsBeforeParking = 20000;
+
+    juce::OwnedArray<Worker> workers;
+
+    void (*task) (void*, size_t) = nullptr;
+    void* taskContext = nullptr;
+    juce::uint64 generation = 0;
+    std::atomic<juce::uint64> job { 0 };
+    std::atomic<size_t> remaining { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (BandWorkerPool)
+};
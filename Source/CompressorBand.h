@@ -10,10 +10,25 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "LinkedCompressor.h"
+#include "ParamInfo.h"
+#include "SnapshotMorph.h"
 
 
+/** The half-band filters used when a band is oversampled. */
+enum class OversamplingQuality
+{
+    LowLatency,     // polyphase IIR, fewest samples of latency
+    HighQuality,    // polyphase IIR with steeper filters
+    LinearPhase     // equiripple FIR, no phase distortion but the most latency
+};
+
+template <typename SampleType>
 struct CompressorBand
 {
+    static constexpr size_t maxOversamplingOrder = 3;   // 8x
+    static constexpr size_t numOversamplingQualities = 3;
+    
     juce::AudioParameterFloat* attack { nullptr };
     juce::AudioParameterFloat* release { nullptr };
     juce::AudioParameterFloat* threshold { nullptr };
@@ -21,30 +36,384 @@ struct CompressorBand
     juce::AudioParameterBool* bypassed { nullptr };
     juce::AudioParameterBool* mute { nullptr };
     juce::AudioParameterBool* solo { nullptr };
+    juce::AudioParameterFloat* knee { nullptr };
+    juce::AudioParameterBool* sidechain { nullptr };
+    // Shared by all bands.
+    juce::AudioParameterChoice* stereoLink { nullptr };
     
+    /** Plain copy of the band's parameter values, taken once per change. */
+    struct Settings
+    {
+        float attack = 50.f;
+        float release = 250.f;
+        float threshold = 0.f;
+        float ratio = 3.f;
+        float knee = 0.f;
+        bool bypassed = false;
+        bool mute = false;
+        bool solo = false;
+        bool keyed = false;
+        StereoLink link = StereoLink::Off;
+    };
+    
+    /** Allocates for every oversampling factor and quality up front, so that
+        switching between them while playing never allocates.
+    */
     void prepare (const juce::dsp::ProcessSpec spec)
     {
-        compressor.prepare(spec);
+        constexpr auto maxFactor = 1u << maxOversamplingOrder;
+        
+        // compressor.prepare() recomputes the coefficients from its settings.
+        finishRamp();
+        
+        auto oversampledSpec = spec;
+        oversampledSpec.sampleRate *= maxFactor;
+        oversampledSpec.maximumBlockSize *= maxFactor;
+        compressor.prepare(oversampledSpec);
+        
+        // Room for the key at the highest rate, see upsampleKey().
+        keyScratch.setSize(static_cast<int>(numKeyChannels), numKeyChannels > 0 ? static_cast<int>(oversampledSpec.maximumBlockSize) : 0);
+        
+        baseSampleRate = spec.sampleRate;
+        
+        for (size_t order = 1; order <= maxOversamplingOrder; ++order)
+        {
+            for (size_t quality = 0; quality < numOversamplingQualities; ++quality)
+            {
+                using Oversampling = juce::dsp::Oversampling<SampleType>;
+                
+                auto q = static_cast<OversamplingQuality>(quality);
+                auto type = q == OversamplingQuality::LinearPhase ? Oversampling::filterHalfBandFIREquiripple
+                                                                  : Oversampling::filterHalfBandPolyphaseIIR;
+                
+                // Integer latency, so the host can compensate for it exactly.
+                auto& oversampler = getOversampler(order, q);
+                oversampler = std::make_unique<Oversampling>(spec.numChannels, order, type,
+                                                             q != OversamplingQuality::LowLatency, true);
+                oversampler->initProcessing(spec.maximumBlockSize);
+            }
+        }
+        
+        activateOversampler();
+    }
+    
+    /** Takes effect immediately and resets the band's dynamics; meant to be
+        chosen once per session rather than automated.
+    */
+    void setOversampling (size_t order, OversamplingQuality quality)
+    {
+        jassert(order <= maxOversamplingOrder);
+        
+        if ( order == oversamplingOrder && quality == oversamplingQuality )
+            return;
+        
+        // The ramp's increments are for the old rate.
+        finishRamp();
+        
+        oversamplingOrder = order;
+        oversamplingQuality = quality;
+        activateOversampler();
+    }
+    
+    /** At the base rate. 0 until prepared. */
+    int getOversamplingLatency (size_t order, OversamplingQuality quality) const
+    {
+        if ( order == 0 )
+            return 0;
+        
+        auto& oversampler = oversamplers[getOversamplerIndex(order, quality)];
+        return oversampler != nullptr ? juce::roundToInt(oversampler->getLatencyInSamples()) : 0;
+    }
+    
+    Settings readSettings (const ParameterReader& read = {}) const
+    {
+        Settings s;
+        s.attack = read(*attack);
+        s.release = read(*release);
+        s.threshold = read(*threshold);
+        s.knee = read(*knee);
+        s.ratio = Params::RatioChoices[static_cast<size_t>(juce::jlimit(0, static_cast<int>(Params::RatioChoices.size()) - 1, read(*ratio)))];
+        s.bypassed = read(*bypassed);
+        s.mute = read(*mute);
+        s.solo = read(*solo);
+        s.keyed = read(*sidechain);
+        s.link = static_cast<StereoLink>(read(*stereoLink));
+        return s;
+    }
+    
+    /** Only the setters whose value actually changed are called, since each
+        one recomputes the compressor's coefficients.
+    */
+    void applySettings (const Settings& s)
+    {
+        if ( ! hasSettings || s.attack != current.attack )
+            compressor.setAttack(s.attack);
+        
+        if ( ! hasSettings || s.release != current.release )
+            compressor.setRelease(s.release);
+        
+        if ( ! hasSettings || s.threshold != current.threshold )
+            compressor.setThreshold(s.threshold);
+        
+        if ( ! hasSettings || s.ratio != current.ratio )
+            compressor.setRatio(s.ratio);
+        
+        if ( ! hasSettings || s.knee != current.knee )
+            compressor.setKnee(s.knee);
+        
+        if ( ! hasSettings || s.link != current.link )
+            compressor.setStereoLink(s.link);
+        
+        current = s;
+        hasSettings = true;
     }
     
-    void updateCompressorSettings ()
+    /** Moves to s in numSteps steps: threshold, knee, attack and release go
+        in equal steps, everything else changes at the first. Applies the
+        first step, so stepRamp() is called numSteps - 1 more times. Jumps
+        straight to s when numSteps is 1 or nothing has been applied yet.
+        Returns true if anything is ramping.
+        
+        What ramps is the compressor's coefficients, not the parameters: the
+        threshold and knee in octaves of level, attack and release as their
+        one-pole coefficients. Their end points and per step increments are
+        worked out here, so the steps in between are additions, with no exp
+        or log. The last step sets s through the compressor's setters, so a
+        ramp ends exactly where a jump would.
+    */
+    bool rampToSettings (const Settings& s, int numSteps)
     {
-        compressor.setAttack(attack->get());
-        compressor.setRelease(release->get());
-        compressor.setThreshold(threshold->get());
-        compressor.setRatio(ratio->getCurrentChoiceName().getFloatValue());
+        finishRamp();
+        target = s;
+        
+        const auto ramps = s.threshold != current.threshold || s.knee != current.knee
+                            || s.attack != current.attack || s.release != current.release;
+        
+        if ( ! hasSettings || numSteps <= 1 || ! ramps )
+        {
+            applySettings(s);
+            return false;
+        }
+        
+        // Everything that doesn't ramp changes now.
+        auto first = s;
+        first.threshold = current.threshold;
+        first.knee = current.knee;
+        first.attack = current.attack;
+        first.release = current.release;
+        applySettings(first);
+        
+        const auto from = compressor.getCoefficients();
+        const auto to = compressor.calculateCoefficients(s.threshold, s.knee, s.attack, s.release);
+        const auto steps = static_cast<SampleType>(numSteps);
+        
+        rampIncrement = { (to.log2Threshold - from.log2Threshold) / steps, (to.kneeOctaves - from.kneeOctaves) / steps,
+                          (to.attack - from.attack) / steps, (to.release - from.release) / steps };
+        rampStepsLeft = numSteps;
+        
+        stepRamp();
+        return isRamping();
     }
     
-    void process (juce::AudioBuffer<float>& buffer)
+    /** The next step towards the settings given to rampToSettings(); once
+        there, nothing more happens.
+    */
+    void stepRamp ()
     {
-        auto block = juce::dsp::AudioBlock<float> ( buffer );
-        auto context = juce::dsp::ProcessContextReplacing<float> ( block );
+        if ( rampStepsLeft <= 0 )
+            return;
         
-        context.isBypassed = bypassed->get();
+        if ( --rampStepsLeft == 0 )
+        {
+            applySettings(target);
+            return;
+        }
         
-        compressor.process( context );
+        auto c = compressor.getCoefficients();
+        c.log2Threshold += rampIncrement.log2Threshold;
+        c.kneeOctaves += rampIncrement.kneeOctaves;
+        c.attack += rampIncrement.attack;
+        c.release += rampIncrement.release;
+        compressor.setCoefficients(c);
+    }
+    
+    bool isRamping () const noexcept
+    {
+        return rampStepsLeft > 0;
+    }
+    
+    /** The settings last applied in full. During a ramp, threshold, knee,
+        attack and release are still the ones it started from.
+    */
+    const Settings& getSettings () const noexcept { return current; }
+    
+    /** Where the current ramp ends; the same as getSettings() when there is none. */
+    const Settings& getTargetSettings () const noexcept { return target; }
+    
+    void setUseReferenceGainMath (bool shouldUseReference) noexcept
+    {
+        compressor.setUseReferenceGainMath(shouldUseReference);
+    }
+    
+    /** Channels of the key given to process(), 0 without a sidechain. Takes effect at the next prepare(). */
+    void setSidechainChannels (size_t numChannels)
+    {
+        numKeyChannels = numChannels;
     }
     
+    /** See LinkedCompressor::setChannelGroups(). Takes effect at the next prepare(). */
+    void setChannelGroups (const std::vector<int>& groups)
+    {
+        compressor.setChannelGroups(groups);
+    }
+    
+    /** Lookahead is global, so it is set by the owner rather than read with the Settings.
+        In samples at the base rate.
+    */
+    void setLookahead (int numSamples) noexcept
+    {
+        lookahead = numSamples;
+        compressor.setLookahead(lookahead << oversamplingOrder);
+    }
+    
+    /** For a band nobody hears: runs the resampling filters, the lookahead
+        delay and the envelopes as process() would, but computes no gain.
+        Leaves the block holding the band uncompressed.
+    */
+    void track (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<const SampleType> key = {})
+    {
+        if ( activeOversampler != nullptr )
+        {
+            compressor.track(activeOversampler->processSamplesUp(block), current.bypassed, upsampleKey(key));
+            activeOversampler->processSamplesDown(block);
+            return;
+        }
+        
+        compressor.track(block, current.bypassed, key);
+    }
+    
+    /** With a key (this band of the sidechain) the detector listens to it instead of the band. */
+    void process (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<const SampleType> key = {})
+    {
+        if ( activeOversampler != nullptr )
+        {
+            compressOversampled(activeOversampler->processSamplesUp(block), upsampleKey(key));
+            activeOversampler->processSamplesDown(block);
+            return;
+        }
+        
+        auto context = juce::dsp::ProcessContextReplacing<SampleType> ( block );
+        
+        context.isBypassed = current.bypassed;
+        
+        compressor.process( context, key );
+    }
+    
+    void process (juce::dsp::AudioBlock<const SampleType> input, juce::dsp::AudioBlock<SampleType> output,
+                  juce::dsp::AudioBlock<const SampleType> key = {})
+    {
+        if ( activeOversampler != nullptr )
+        {
+            compressOversampled(activeOversampler->processSamplesUp(input), upsampleKey(key));
+            activeOversampler->processSamplesDown(output);
+            return;
+        }
+        
+        auto context = juce::dsp::ProcessContextNonReplacing<SampleType> ( input, output );
+        
+        context.isBypassed = current.bypassed;
+        
+        compressor.process( context, key );
+    }
+
 private:
-    juce::dsp::Compressor<float> compressor;
+    using OversamplerPtr = std::unique_ptr<juce::dsp::Oversampling<SampleType>>;
+    
+    void finishRamp()
+    {
+        if ( isRamping() )
+        {
+            rampStepsLeft = 0;
+            applySettings(target);
+        }
+    }
+    
+    static size_t getOversamplerIndex (size_t order, OversamplingQuality quality)
+    {
+        jassert(order >= 1 && order <= maxOversamplingOrder);
+        return (order - 1) * numOversamplingQualities + static_cast<size_t>(quality);
+    }
+    
+    OversamplerPtr& getOversampler (size_t order, OversamplingQuality quality)
+    {
+        return oversamplers[getOversamplerIndex(order, quality)];
+    }
+    
+    void activateOversampler()
+    {
+        activeOversampler = oversamplingOrder > 0 ? getOversampler(oversamplingOrder, oversamplingQuality).get() : nullptr;
+        
+        if ( activeOversampler != nullptr )
+            activeOversampler->reset();
+        
+        // Not prepared yet; prepare() calls this again.
+        if ( baseSampleRate <= 0.0 )
+            return;
+        
+        compressor.setSampleRate(baseSampleRate * static_cast<double>(1 << oversamplingOrder));
+        compressor.setLookahead(lookahead << oversamplingOrder);
+    }
+    
+    // The bypassed flag still applies, but the signal goes through the same
+    // resampling filters, so a bypassed band stays aligned with the others.
+    void compressOversampled (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<const SampleType> key)
+    {
+        auto context = juce::dsp::ProcessContextReplacing<SampleType> ( block );
+        
+        context.isBypassed = current.bypassed;
+        
+        compressor.process( context, key );
+    }
+    
+    // The key only feeds the detector, so it is brought up to the oversampled
+    // rate by repeating each sample rather than through another set of
+    // resampling filters. It leads the band by the up-filter's delay.
+    juce::dsp::AudioBlock<const SampleType> upsampleKey (juce::dsp::AudioBlock<const SampleType> key)
+    {
+        const auto numChannels = juce::jmin(key.getNumChannels(), static_cast<size_t>(keyScratch.getNumChannels()));
+        if ( numChannels == 0 )
+            return {};
+        
+        const auto factor = size_t(1) << oversamplingOrder;
+        const auto numSamples = key.getNumSamples();
+        jassert(numSamples * factor <= static_cast<size_t>(keyScratch.getNumSamples()));
+        
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* in = key.getChannelPointer(ch);
+            auto* out = keyScratch.getWritePointer(static_cast<int>(ch));
+            
+            for (size_t i = 0; i < numSamples; ++i)
+                std::fill_n(out + i * factor, factor, in[i]);
+        }
+        
+        return juce::dsp::AudioBlock<const SampleType>(keyScratch).getSubsetChannelBlock(0, numChannels)
+                                                                  .getSubBlock(0, numSamples * factor);
+    }
+    
+    LinkedCompressor<SampleType> compressor;
+    Settings current, target;
+    bool hasSettings = false;
+    typename LinkedCompressor<SampleType>::Coefficients rampIncrement;
+    int rampStepsLeft = 0;
+    
+    double baseSampleRate = 0.0;
+    int lookahead = 0;
+    size_t oversamplingOrder = 0;
+    OversamplingQuality oversamplingQuality = OversamplingQuality::LowLatency;
+    std::array<OversamplerPtr, maxOversamplingOrder * numOversamplingQualities> oversamplers;
+    juce::dsp::Oversampling<SampleType>* activeOversampler { nullptr };
+    
+    size_t numKeyChannels = 0;
+    juce::AudioBuffer<SampleType> keyScratch;
 };
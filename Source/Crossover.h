@@ -0,0 +1,460 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 17 Oct 2026 3:49:53am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SIMDFrames.h"
+
+template <typename Fn, size_t... Indices>
+inline void staticForImpl (Fn&& fn, std::index_sequence<Indices...>)
+{
+    (fn(std::integral_constant<size_t, Indices>{}), ...);
+}
+
+/** Calls fn(std::integral_constant<size_t, I>) for I = 0 .. N-1, fully unrolled. */
+template <size_t N, typename Fn>
+inline void staticFor (Fn&& fn)
+{
+    staticForImpl(fn, std::make_index_sequence<N>{});
+}
+
+/*
+    g = tan(pi fc / fs) and h = 1 / (1 + R2 g + g^2) for every TPT stage of
+    the crossover, tabulated once per sample rate on a dense log frequency
+    grid from 20 Hz to 20 kHz. That spans every crossover parameter range, so
+    a single table is shared by all the splits.
+
+    Positions are in table steps (fractional). Neighbouring entries are
+    0.34% apart in frequency; linear interpolation between them puts the
+    cutoff within a few parts per million of the exact one.
+*/
+template <typename SampleType>
+class CrossoverCoefficientTable
+{
+public:
+    struct Entry
+    {
+        SampleType g, h;
+    };
+
+    static constexpr size_t size = 2048;
+    static constexpr double minFrequency = 20.0;
+    static constexpr double maxFrequency = 20000.0;
+
+    /** Allocates, so call from prepareToPlay. */
+    void build (double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        entries.resize(size);
+
+        const auto r2 = std::sqrt(2.0);
+        const auto nyquistLimit = 0.499 * sampleRate;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto frequency = juce::jmin(minFrequency * std::exp2(static_cast<double>(i) / stepsPerOctave), nyquistLimit);
+            const auto g = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+            entries[i] = { static_cast<SampleType>(g), static_cast<SampleType>(1.0 / (1.0 + r2 * g + g * g)) };
+        }
+    }
+
+    bool isBuilt() const noexcept { return ! entries.empty(); }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /** Frequencies outside 20 Hz - 20 kHz are clamped to the table's ends. */
+    static SampleType getPosition (SampleType frequency) noexcept
+    {
+        const auto f = juce::jlimit(minFrequency, maxFrequency, static_cast<double>(frequency));
+        return static_cast<SampleType>(std::log2(f / minFrequency) * stepsPerOctave);
+    }
+
+    Entry lookup (SampleType position) const noexcept
+    {
+        jassert(isBuilt());
+
+        const auto clamped = juce::jlimit(SampleType(0), static_cast<SampleType>(size - 1), position);
+        const auto index = juce::jmin(static_cast<size_t>(clamped), size - 2);
+        const auto frac = clamped - static_cast<SampleType>(index);
+
+        const auto& a = entries[index];
+        const auto& b = entries[index + 1];
+        return { a.g + frac * (b.g - a.g), a.h + frac * (b.h - a.h) };
+    }
+
+private:
+    static inline const double stepsPerOctave = static_cast<double>(size - 1) / std::log2(maxFrequency / minFrequency);
+
+    double sampleRate = 0.0;
+    std::vector<Entry> entries;
+};
+
+/** How the crossover follows a change of cutoff. */
+enum class CrossoverSweepMode
+{
+    // Jump to the new cutoff at the start of the next block, with freshly
+    // computed coefficients. Bit exact with the LinkwitzRileyFilter tree.
+    Stepped,
+    // Glide to the new cutoff over sweepTimeSeconds on a log frequency
+    // scale, with per sample coefficients read from the shared table.
+    Smoothed
+};
+
+/*
+    N band Linkwitz-Riley crossover computed in a single pass per sample
+    frame, with channels packed into SIMD lanes (juce::dsp::SIMDRegister, so
+    SSE/AVX on x86 and NEON on ARM).
+
+    For three bands it replaces this tree of juce::dsp::LinkwitzRileyFilter
+    instances, and the same shape extends to any band count:
+
+              FC0     FC1     FC2 ...
+        x --> LP0 --> AP1 --> AP2       --> band 0
+          \-> HP0 --> LP1 --> AP2       --> band 1
+                  \-> HP1 --> LP2       --> band 2
+                          \-> HP2       --> band 3
+
+    Each split's LP and HP run the same first 2nd order stage over the same
+    input, so that stage is shared. The tree is generated at compile time
+    and unrolled; the filter state stays in registers for the whole block,
+    and the channels are moved in and out of lanes a tile of frames at a time.
+
+    Every lane does exactly the arithmetic LinkwitzRileyFilter::processSample
+    does, in the same order, so in Stepped mode the output matches the filter
+    tree bit for bit unless the compiler contracts to FMA. With FMA
+    contraction the difference stays below 1e-6 relative to full scale
+    (-120 dB). In Smoothed mode the coefficients come from the table instead.
+*/
+template <typename SampleType, size_t NumBands>
+class LinkwitzRileyCrossover
+{
+public:
+    static_assert(NumBands >= 2, "A crossover needs at least two bands");
+
+    static constexpr size_t numSplits = NumBands - 1;
+    static constexpr size_t numAllpasses = (numSplits - 1) * numSplits / 2;
+
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    using BandBlocks = std::array<juce::dsp::AudioBlock<SampleType>, NumBands>;
+
+    using Table = CrossoverCoefficientTable<SampleType>;
+
+    static constexpr double sweepTimeSeconds = 0.05;
+
+    /** The table has to be built for spec.sampleRate and outlive the crossover. */
+    void prepare (const juce::dsp::ProcessSpec& spec, const Table& coefficientTable)
+    {
+        jassert(coefficientTable.isBuilt() && coefficientTable.getSampleRate() == spec.sampleRate);
+
+        table = &coefficientTable;
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        state.resize((numChannels + Vec::size() - 1) / Vec::size());
+        sweep.resize(juce::jmax(static_cast<size_t>(spec.maximumBlockSize), static_cast<size_t>(1)));
+
+        for (size_t k = 0; k < numSplits; ++k)
+        {
+            position[k].reset(sampleRate, sweepTimeSeconds);
+            position[k].setCurrentAndTargetValue(Table::getPosition(cutoff[k]));
+        }
+
+        reset();
+        update();
+    }
+
+    void setSweepMode (CrossoverSweepMode newMode)
+    {
+        if (newMode == mode)
+            return;
+
+        mode = newMode;
+
+        for (size_t k = 0; k < numSplits; ++k)
+            position[k].setCurrentAndTargetValue(Table::getPosition(cutoff[k]));
+
+        update();
+    }
+
+    CrossoverSweepMode getSweepMode() const noexcept { return mode; }
+
+    /** Clears the filter state and finishes any sweep in progress. */
+    void reset()
+    {
+        for (auto& group : state)
+            group = {};
+
+        if (isSweeping())
+        {
+            for (auto& p : position)
+                p.setCurrentAndTargetValue(p.getTargetValue());
+
+            update();
+        }
+    }
+
+    void setCrossoverFrequencies (const std::array<SampleType, numSplits>& newCutoffs)
+    {
+        jassert(std::all_of(newCutoffs.begin(), newCutoffs.end(), [this] (auto f)
+                            { return f > 0 && f <= static_cast<SampleType>(sampleRate * 0.5); }));
+
+        if (newCutoffs == cutoff)
+            return;
+
+        cutoff = newCutoffs;
+
+        // The very first cutoffs are jumped to, not swept to from 0 Hz.
+        const auto isFirstUpdate = ! hasCutoffs;
+        hasCutoffs = true;
+
+        if (mode == CrossoverSweepMode::Stepped || table == nullptr || isFirstUpdate)
+        {
+            for (size_t k = 0; k < numSplits; ++k)
+                position[k].setCurrentAndTargetValue(Table::getPosition(cutoff[k]));
+
+            update();
+            return;
+        }
+
+        // No trig here; the sweep reads the table as it goes.
+        for (size_t k = 0; k < numSplits; ++k)
+            position[k].setTargetValue(Table::getPosition(cutoff[k]));
+    }
+
+    bool isSweeping() const noexcept
+    {
+        return std::any_of(position.begin(), position.end(), [] (const auto& p) { return p.isSmoothing(); });
+    }
+
+    /** Splits input into the band blocks, lowest band first.
+        The input may alias any one of the outputs; each tile of frames is read before any of it is written.
+    */
+    void process (const juce::dsp::AudioBlock<const SampleType>& input, const BandBlocks& bands) noexcept
+    {
+        const auto numSamples = input.getNumSamples();
+        const auto channels = juce::jmin(input.getNumChannels(), numChannels);
+
+        jassert(std::all_of(bands.begin(), bands.end(), [=] (const auto& band)
+                            { return band.getNumSamples() >= numSamples && band.getNumChannels() >= channels; }));
+
+        if (mode == CrossoverSweepMode::Smoothed && isSweeping())
+        {
+            jassert(numSamples <= sweep.size());
+
+            // Every channel group follows the same trajectory, so it is read
+            // from the table once per block rather than once per group.
+            for (size_t i = 0; i < numSamples; ++i)
+                for (size_t k = 0; k < numSplits; ++k)
+                    sweep[i][k] = table->lookup(position[k].getNextValue());
+
+            for (size_t k = 0; k < numSplits; ++k)
+            {
+                g[k] = sweep[numSamples - 1][k].g;
+                h[k] = sweep[numSamples - 1][k].h;
+            }
+
+            processGroups<true>(input, bands, numSamples, channels);
+        }
+        else
+        {
+            processGroups<false>(input, bands, numSamples, channels);
+        }
+    }
+
+private:
+    struct Coefficients
+    {
+        Vec g, k, h;
+    };
+
+    struct SplitState
+    {
+        Vec s1, s2;             // LPk/HPk shared stage
+        Vec lp1, lp2;           // LPk second stage
+        Vec hp1, hp2;           // HPk second stage
+    };
+
+    struct AllpassState
+    {
+        Vec s1, s2;
+    };
+
+    struct GroupState
+    {
+        std::array<SplitState, numSplits> splits;
+        std::array<AllpassState, (numAllpasses > 0 ? numAllpasses : 1)> allpasses;
+    };
+
+    // Frames per tile. Each tile of a channel group is interleaved into
+    // frames once, run through the tree a register per frame, and each band
+    // is de-interleaved once; the tiles live on the stack.
+    static constexpr size_t tileSize = 64;
+
+    template <bool PerSampleCoefficients>
+    void processGroups (const juce::dsp::AudioBlock<const SampleType>& input, const BandBlocks& bands,
+                        size_t numSamples, size_t channels) noexcept
+    {
+        const auto r2 = Vec::expand(R2);
+        std::array<Coefficients, numSplits> coeffs;
+        for (size_t k = 0; k < numSplits; ++k)
+            coeffs[k] = makeCoefficients(g[k], h[k]);
+
+        alignas(Vec::SIMDRegisterSize) SampleType frames[tileSize * Vec::size()];
+        alignas(Vec::SIMDRegisterSize) SampleType bandFrames[NumBands][tileSize * Vec::size()];
+
+        for (size_t group = 0; group < state.size(); ++group)
+        {
+            const auto firstChannel = group * Vec::size();
+            if (firstChannel >= channels)
+                break;
+
+            const auto numLanes = juce::jmin(Vec::size(), channels - firstChannel);
+
+            const SampleType* in[Vec::size()] {};
+            SampleType* out[NumBands][Vec::size()] {};
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                in[lane] = input.getChannelPointer(firstChannel + lane);
+                for (size_t b = 0; b < NumBands; ++b)
+                    out[b][lane] = bands[b].getChannelPointer(firstChannel + lane);
+            }
+
+            auto s = state[group];
+
+            for (size_t tileStart = 0; tileStart < numSamples; tileStart += tileSize)
+            {
+                const auto tileLength = juce::jmin(tileSize, numSamples - tileStart);
+                SIMDFrames::interleave(in, numLanes, tileStart, tileLength, frames);
+
+                for (size_t i = 0; i < tileLength; ++i)
+                {
+                    auto rest = Vec::fromRawArray(frames + i * Vec::size());
+                    std::array<Vec, NumBands> y;
+
+                    if constexpr (PerSampleCoefficients)
+                    {
+                        for (size_t k = 0; k < numSplits; ++k)
+                            coeffs[k] = makeCoefficients(sweep[tileStart + i][k].g, sweep[tileStart + i][k].h);
+                    }
+
+                    staticFor<numSplits>([&] (auto k)
+                    {
+                        auto& split = s.splits[k];
+                        const auto& c = coeffs[k];
+
+                        // LPk / HPk shared first stage
+                        Vec yH, yB, yL;
+                        tick(rest, split.s1, split.s2, c, yH, yB, yL);
+
+                        Vec lpH, lpB;
+                        tick(yL, split.lp1, split.lp2, c, lpH, lpB, y[k]);
+
+                        Vec hpB, hpL;
+                        tick(yH, split.hp1, split.hp2, c, rest, hpB, hpL);
+
+                        // APk on every band below this split
+                        staticFor<decltype(k)::value>([&] (auto band)
+                        {
+                            auto& ap = s.allpasses[allpassIndex(k, band)];
+                            Vec apH, apB, apL;
+                            tick(y[band], ap.s1, ap.s2, c, apH, apB, apL);
+                            y[band] = apL - r2 * apB + apH;
+                        });
+                    });
+
+                    y[numSplits] = rest;
+
+                    for (size_t b = 0; b < NumBands; ++b)
+                        y[b].copyToRawArray(bandFrames[b] + i * Vec::size());
+                }
+
+                for (size_t b = 0; b < NumBands; ++b)
+                    SIMDFrames::deinterleave(bandFrames[b], tileLength, out[b], numLanes, tileStart);
+            }
+
+            snapToZero(s);
+            state[group] = s;
+        }
+    }
+
+    static constexpr size_t allpassIndex (size_t split, size_t band) noexcept
+    {
+        return (split - 1) * split / 2 + band;
+    }
+
+    Coefficients makeCoefficients (SampleType gk, SampleType hk) const noexcept
+    {
+        return { Vec::expand(gk), Vec::expand(R2 + gk), Vec::expand(hk) };
+    }
+
+    // One TPT state variable stage, exactly as LinkwitzRileyFilter::processSample.
+    static inline void tick (Vec x, Vec& s1, Vec& s2, const Coefficients& c,
+                             Vec& yH, Vec& yB, Vec& yL) noexcept
+    {
+        yH = (x - c.k * s1 - s2) * c.h;
+        yB = c.g * yH + s1;
+        s1 = c.g * yH + yB;
+        yL = c.g * yB + s2;
+        s2 = c.g * yB + yL;
+    }
+
+    static void snapToZero (Vec& v) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()];
+        v.copyToRawArray(lanes);
+        for (auto& lane : lanes)
+            juce::dsp::util::snapToZero(lane);
+        v = Vec::fromRawArray(lanes);
+    }
+
+    static void snapToZero (GroupState& s) noexcept
+    {
+        for (auto& split : s.splits)
+            for (auto* v : { &split.s1, &split.s2, &split.lp1, &split.lp2, &split.hp1, &split.hp2 })
+                snapToZero(*v);
+
+        for (auto& ap : s.allpasses)
+        {
+            snapToZero(ap.s1);
+            snapToZero(ap.s2);
+        }
+    }
+
+    void update()
+    {
+        for (size_t k = 0; k < numSplits; ++k)
+        {
+            if (mode == CrossoverSweepMode::Smoothed && table != nullptr)
+            {
+                const auto entry = table->lookup(position[k].getCurrentValue());
+                g[k] = entry.g;
+                h[k] = entry.h;
+            }
+            else
+            {
+                g[k] = static_cast<SampleType>(std::tan(juce::MathConstants<double>::pi * cutoff[k] / sampleRate));
+                h[k] = static_cast<SampleType>(1.0 / (1.0 + R2 * g[k] + g[k] * g[k]));
+            }
+        }
+    }
+
+    SampleType R2 = static_cast<SampleType>(std::sqrt(2.0));
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0;
+    std::array<SampleType, numSplits> cutoff {};
+    bool hasCutoffs = false;
+    std::array<SampleType, numSplits> g {}, h {};
+
+    CrossoverSweepMode mode = CrossoverSweepMode::Smoothed;
+    const Table* table = nullptr;
+    std::array<juce::SmoothedValue<SampleType>, numSplits> position;
+    std::vector<std::array<typename Table::Entry, numSplits>> sweep;
+
+    std::vector<GroupState> state;
+};
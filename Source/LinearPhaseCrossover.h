@@ -0,0 +1,577 @@
+/*
+  ==============================================================================
+
+    LinearPhaseCrossover.h
+    Created: 17 Oct 2026 4:17:11am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Real-only FFT with the interface and data layout of juce::dsp::FFT, in
+    either precision. juce::dsp::FFT only does float, so that is what the
+    float version uses; the double version is a plain radix-2 transform
+    with its twiddles and scratch allocated up front.
+
+    Forward: size() real samples in, size() / 2 + 1 complex bins out,
+    interleaved. Inverse: those bins in, size() real samples out, scaled
+    by 1 / size() so a round trip gives the input back.
+*/
+template <typename SampleType>
+class RealFFT
+{
+public:
+    explicit RealFFT (int order)
+        : fftSize(1 << order),
+          twiddles(static_cast<size_t>(fftSize / 2)),
+          bitReversed(static_cast<size_t>(fftSize)),
+          scratch(static_cast<size_t>(fftSize))
+    {
+        for (size_t i = 0; i < twiddles.size(); ++i)
+        {
+            const auto angle = -juce::MathConstants<double>::twoPi * static_cast<double>(i) / fftSize;
+            twiddles[i] = { static_cast<SampleType>(std::cos(angle)), static_cast<SampleType>(std::sin(angle)) };
+        }
+
+        for (int i = 0, j = 0; i < fftSize; ++i)
+        {
+            bitReversed[static_cast<size_t>(i)] = static_cast<size_t>(j);
+
+            auto bit = fftSize >> 1;
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+            j |= bit;
+        }
+    }
+
+    int getSize() const noexcept { return fftSize; }
+
+    void performRealOnlyForwardTransform (SampleType* data, bool) noexcept
+    {
+        for (int i = 0; i < fftSize; ++i)
+            scratch[bitReversed[static_cast<size_t>(i)]] = { data[i], SampleType() };
+
+        transform(false);
+
+        for (int k = 0; k <= fftSize / 2; ++k)
+        {
+            data[2 * k]     = scratch[static_cast<size_t>(k)].real();
+            data[2 * k + 1] = scratch[static_cast<size_t>(k)].imag();
+        }
+    }
+
+    void performRealOnlyInverseTransform (SampleType* data) noexcept
+    {
+        // The missing half is the complex conjugate of the one given.
+        for (int k = 0; k < fftSize; ++k)
+        {
+            const auto bin = k <= fftSize / 2 ? k : fftSize - k;
+            const auto value = Complex { data[2 * bin], k <= fftSize / 2 ? data[2 * bin + 1] : -data[2 * bin + 1] };
+            scratch[bitReversed[static_cast<size_t>(k)]] = value;
+        }
+
+        transform(true);
+
+        const auto scale = SampleType(1) / static_cast<SampleType>(fftSize);
+        for (int i = 0; i < fftSize; ++i)
+            data[i] = scratch[static_cast<size_t>(i)].real() * scale;
+    }
+
+private:
+    using Complex = std::complex<SampleType>;
+
+    // In place on bit-reversed input.
+    void transform (bool inverse) noexcept
+    {
+        for (int half = 1; half < fftSize; half <<= 1)
+        {
+            const auto step = static_cast<size_t>(fftSize / (2 * half));
+
+            for (int start = 0; start < fftSize; start += 2 * half)
+            {
+                for (int i = 0; i < half; ++i)
+                {
+                    const auto& w = twiddles[static_cast<size_t>(i) * step];
+                    const auto wr = w.real(), wi = inverse ? -w.imag() : w.imag();
+
+                    // Written out, so std::complex's inf/nan handling stays out of the loop.
+                    auto& a = scratch[static_cast<size_t>(start + i)];
+                    auto& b = scratch[static_cast<size_t>(start + i + half)];
+                    const auto tr = wr * b.real() - wi * b.imag();
+                    const auto ti = wr * b.imag() + wi * b.real();
+                    b = { a.real() - tr, a.imag() - ti };
+                    a = { a.real() + tr, a.imag() + ti };
+                }
+            }
+        }
+    }
+
+    int fftSize;
+    std::vector<Complex> twiddles;
+    std::vector<size_t> bitReversed;
+    std::vector<Complex> scratch;
+};
+
+template <>
+class RealFFT<float>
+{
+public:
+    explicit RealFFT (int order) : fft(order) {}
+
+    int getSize() const noexcept { return fft.getSize(); }
+
+    void performRealOnlyForwardTransform (float* data, bool onlyCalculateNonNegativeFrequencies) const noexcept
+    {
+        fft.performRealOnlyForwardTransform(data, onlyCalculateNonNegativeFrequencies);
+    }
+
+    void performRealOnlyInverseTransform (float* data) const noexcept
+    {
+        fft.performRealOnlyInverseTransform(data);
+    }
+
+private:
+    juce::dsp::FFT fft;
+};
+
+/*
+    N band linear-phase crossover: the same Linkwitz-Riley magnitudes as
+    LinkwitzRileyCrossover, but as symmetric FIR kernels, so no band has any
+    phase shift and the bands sum back to a pure delay.
+
+    Each split's lowpass is the zero-phase response 1 / (1 + (f/fc)^4),
+    turned into a kernel of kernelLength taps centred on kernelLength / 2.
+    Band 0 is the first lowpass, band k the difference of lowpasses k and
+    k - 1, and the top band a unit impulse minus the last lowpass, so the
+    kernels add up to exactly one impulse whatever the cutoffs.
+
+    The kernels are applied with uniformly partitioned overlap-save
+    convolution: partitionSize samples are buffered, transformed once per
+    channel into a frequency domain delay line shared by all bands, and each
+    band multiplies that line by its kernel partitions and transforms back.
+    All of that happens in the callback that completes a partition, so the
+    partition follows the largest block prepare() was given: small blocks
+    get small partitions and every callback does about the same work,
+    rather than one in every few doing all of it. Everything, the FFTs
+    included, runs in SampleType, and nothing is allocated after prepare().
+
+    New cutoffs are designed on a background thread and handed over through
+    a set of four preallocated kernel slots. The first partition after a
+    hand-over is computed with both the old and the new kernels and
+    crossfaded. The audio thread only bumps a serial number; the designer
+    looks at it every few milliseconds, and only runs at all while
+    setDesignerActive() says the crossover is in use.
+
+    Latency is kernelLength / 2 + partitionSize samples, so it depends on
+    the block size as well as the sample rate.
+*/
+template <typename SampleType, size_t NumBands>
+class LinearPhaseCrossover
+{
+public:
+    static_assert(NumBands >= 2, "A crossover needs at least two bands");
+
+    static constexpr size_t numSplits = NumBands - 1;
+    static constexpr int minPartitionSize = 32, maxPartitionSize = 256;
+
+    using BandBlocks = std::array<juce::dsp::AudioBlock<SampleType>, NumBands>;
+    using Cutoffs = std::array<SampleType, numSplits>;
+
+    LinearPhaseCrossover() = default;
+
+    ~LinearPhaseCrossover()
+    {
+        designer.stopThread(1000);
+    }
+
+    /** About 150 ms of taps, enough for the 20 Hz lowpass to die away. */
+    static int getKernelLength (double sampleRate)
+    {
+        return juce::nextPowerOfTwo(juce::jmax(2 * maxPartitionSize, static_cast<int>(sampleRate * 0.15)));
+    }
+
+    /** The smallest power of two that holds a whole block, within limits. */
+    static int getPartitionSize (int maximumBlockSize)
+    {
+        return juce::jlimit(minPartitionSize, maxPartitionSize, juce::nextPowerOfTwo(juce::jmax(1, maximumBlockSize)));
+    }
+
+    static int getLatencySamples (double sampleRate, int maximumBlockSize)
+    {
+        return getKernelLength(sampleRate) / 2 + getPartitionSize(maximumBlockSize);
+    }
+
+    int getLatencySamples() const noexcept
+    {
+        return kernelLength / 2 + partitionSize;
+    }
+
+    /** Starts or stops the thread that designs the kernels for new cutoffs.
+        Message thread. Cutoffs set while it is stopped are designed once it
+        starts again; until then the last kernels stay in use.
+    */
+    void setDesignerActive (bool shouldBeActive)
+    {
+        designerActive = shouldBeActive;
+
+        if (! shouldBeActive)
+            designer.stopThread(1000);
+        else if (kernelLength > 0)
+            designer.startThread(3);
+    }
+
+    /** Designs the kernels for initialCutoffs before returning. */
+    void prepare (const juce::dsp::ProcessSpec& spec, const Cutoffs& initialCutoffs)
+    {
+        designer.stopThread(1000);
+
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        kernelLength = getKernelLength(sampleRate);
+        partitionSize = getPartitionSize(static_cast<int>(spec.maximumBlockSize));
+        binStride = 2 * static_cast<size_t>(partitionSize + 1);
+        numPartitions = static_cast<size_t>(kernelLength / partitionSize);
+
+        const auto partitionOrder = juce::roundToInt(std::log2(2 * partitionSize));
+        partitionFFT = std::make_unique<RealFFT<SampleType>>(partitionOrder);
+        partitionFFTForDesign = std::make_unique<RealFFT<SampleType>>(partitionOrder);
+        kernelFFT = std::make_unique<RealFFT<SampleType>>(juce::roundToInt(std::log2(kernelLength)));
+
+        const auto spectrumSize = numPartitions * binStride;
+        for (auto& slot : kernels)
+            slot.assign(NumBands * spectrumSize, SampleType());
+
+        inputFrames.assign(numChannels, std::vector<SampleType>(2 * static_cast<size_t>(partitionSize), SampleType()));
+        delayLines.assign(numChannels, std::vector<SampleType>(spectrumSize, SampleType()));
+        for (auto& band : outputs)
+            band.assign(numChannels, std::vector<SampleType>(static_cast<size_t>(partitionSize), SampleType()));
+
+        fftBuffer.assign(4 * static_cast<size_t>(partitionSize), SampleType());
+        fadeBuffer.assign(static_cast<size_t>(partitionSize), SampleType());
+        accumulator.assign(binStride, SampleType());
+
+        designSpectrum.assign(2 * static_cast<size_t>(kernelLength), SampleType());
+        designLowpasses.assign(numSplits, std::vector<SampleType>(static_cast<size_t>(kernelLength), SampleType()));
+        designKernel.assign(static_cast<size_t>(kernelLength), SampleType());
+        designPartition.assign(4 * static_cast<size_t>(partitionSize), SampleType());
+
+        fadeIn.resize(static_cast<size_t>(partitionSize));
+        for (int i = 0; i < partitionSize; ++i)
+            fadeIn[static_cast<size_t>(i)] = (static_cast<SampleType>(i) + SampleType(0.5)) / static_cast<SampleType>(partitionSize);
+
+        front = 0;
+        spare = 1;
+        fadingFrom = -1;
+        pending.store(2);
+        back = 3;
+
+        cutoff = initialCutoffs;
+        for (size_t k = 0; k < numSplits; ++k)
+            requestedCutoffs[k].store(static_cast<float>(cutoff[k]));
+
+        designKernels(kernels[static_cast<size_t>(front)]);
+        designedSerial = requestSerial.load();
+
+        reset();
+
+        if (designerActive)
+            designer.startThread(3);
+    }
+
+    /** Clears the convolution state. Audio thread only. */
+    void reset()
+    {
+        for (auto& frame : inputFrames)
+            std::fill(frame.begin(), frame.end(), SampleType());
+
+        for (auto& line : delayLines)
+            std::fill(line.begin(), line.end(), SampleType());
+
+        for (auto& band : outputs)
+            for (auto& channel : band)
+                std::fill(channel.begin(), channel.end(), SampleType());
+
+        fifoPosition = 0;
+        delayLinePosition = 0;
+        finishFade();
+    }
+
+    /** Never waits and never takes a lock: the kernels for the new cutoffs
+        follow a few milliseconds later, once the designer notices.
+    */
+    void setCrossoverFrequencies (const Cutoffs& newCutoffs)
+    {
+        if (newCutoffs == cutoff)
+            return;
+
+        cutoff = newCutoffs;
+
+        for (size_t k = 0; k < numSplits; ++k)
+            requestedCutoffs[k].store(static_cast<float>(cutoff[k]), std::memory_order_relaxed);
+
+        requestSerial.fetch_add(1, std::memory_order_release);
+    }
+
+    /** Splits input into the band blocks, lowest band first, delayed by getLatencySamples().
+        The input may alias any one of the outputs; each sample is read before it is written.
+    */
+    void process (const juce::dsp::AudioBlock<const SampleType>& input, const BandBlocks& bands) noexcept
+    {
+        const auto numSamples = input.getNumSamples();
+        const auto channels = juce::jmin(input.getNumChannels(), numChannels);
+
+        for (size_t done = 0; done < numSamples;)
+        {
+            const auto n = juce::jmin(numSamples - done, static_cast<size_t>(partitionSize - fifoPosition));
+
+            for (size_t ch = 0; ch < channels; ++ch)
+            {
+                const auto* in = input.getChannelPointer(ch) + done;
+                std::copy(in, in + n, inputFrames[ch].begin() + partitionSize + fifoPosition);
+            }
+
+            for (size_t band = 0; band < NumBands; ++band)
+            {
+                for (size_t ch = 0; ch < channels; ++ch)
+                {
+                    const auto from = outputs[band][ch].begin() + fifoPosition;
+                    std::copy(from, from + static_cast<std::ptrdiff_t>(n), bands[band].getChannelPointer(ch) + done);
+                }
+            }
+
+            fifoPosition += static_cast<int>(n);
+            done += n;
+
+            if (fifoPosition == partitionSize)
+            {
+                processPartition(channels);
+                fifoPosition = 0;
+            }
+        }
+    }
+
+private:
+    SampleType* getKernelPartition (int slot, size_t band, size_t partition) noexcept
+    {
+        return kernels[static_cast<size_t>(slot)].data() + (band * numPartitions + partition) * binStride;
+    }
+
+    void processPartition (size_t channels) noexcept
+    {
+        pickUpKernels();
+
+        for (size_t ch = 0; ch < channels; ++ch)
+        {
+            // The newest 2 * partitionSize input samples go into the delay line as one spectrum.
+            auto& frame = inputFrames[ch];
+            std::copy(frame.begin(), frame.end(), fftBuffer.begin());
+            partitionFFT->performRealOnlyForwardTransform(fftBuffer.data(), true);
+            std::copy(fftBuffer.begin(), fftBuffer.begin() + binStride, delayLines[ch].begin() + static_cast<std::ptrdiff_t>(delayLinePosition * binStride));
+            std::copy(frame.begin() + partitionSize, frame.end(), frame.begin());
+
+            for (size_t band = 0; band < NumBands; ++band)
+            {
+                auto& out = outputs[band][ch];
+                convolve(front, band, ch, out.data());
+
+                if (fadingFrom >= 0)
+                {
+                    convolve(fadingFrom, band, ch, fadeBuffer.data());
+
+                    for (int i = 0; i < partitionSize; ++i)
+                    {
+                        const auto w = fadeIn[static_cast<size_t>(i)];
+                        out[static_cast<size_t>(i)] = fadeBuffer[static_cast<size_t>(i)] + w * (out[static_cast<size_t>(i)] - fadeBuffer[static_cast<size_t>(i)]);
+                    }
+                }
+            }
+        }
+
+        delayLinePosition = (delayLinePosition + 1) % numPartitions;
+        finishFade();
+    }
+
+    // One band's output for the newest partition: the delay line times the
+    // kernel partitions, summed in the frequency domain and transformed back.
+    void convolve (int slot, size_t band, size_t ch, SampleType* out) noexcept
+    {
+        std::fill(accumulator.begin(), accumulator.end(), SampleType());
+        auto* acc = accumulator.data();
+
+        for (size_t p = 0; p < numPartitions; ++p)
+        {
+            const auto* x = delayLines[ch].data() + ((delayLinePosition + numPartitions - p) % numPartitions) * binStride;
+            const auto* h = getKernelPartition(slot, band, p);
+
+            for (size_t i = 0; i < binStride; i += 2)
+            {
+                acc[i]     += x[i] * h[i]     - x[i + 1] * h[i + 1];
+                acc[i + 1] += x[i] * h[i + 1] + x[i + 1] * h[i];
+            }
+        }
+
+        std::copy(accumulator.begin(), accumulator.end(), fftBuffer.begin());
+        partitionFFT->performRealOnlyInverseTransform(fftBuffer.data());
+
+        // Overlap-save: only the second half is free of circular wrap-around.
+        std::copy(fftBuffer.begin() + partitionSize, fftBuffer.begin() + 2 * partitionSize, out);
+    }
+
+    //==============================================================================
+    // Kernel slots: the audio thread owns front, spare and fadingFrom, the
+    // designer owns back, and pending is passed between them. A slot with
+    // freshKernels set in pending has not been picked up yet.
+    static constexpr int freshKernels = 4;
+    static constexpr int slotMask = 3;
+
+    void pickUpKernels() noexcept
+    {
+        if (fadingFrom >= 0 || (pending.load(std::memory_order_acquire) & freshKernels) == 0)
+            return;
+
+        // Only the designer makes a slot fresh, so this still gets a fresh one.
+        const auto incoming = pending.exchange(spare, std::memory_order_acq_rel) & slotMask;
+        fadingFrom = front;
+        front = incoming;
+        spare = -1;
+    }
+
+    void finishFade() noexcept
+    {
+        if (fadingFrom < 0)
+            return;
+
+        spare = fadingFrom;
+        fadingFrom = -1;
+    }
+
+    //==============================================================================
+    void designKernels (std::vector<SampleType>& dest)
+    {
+        const auto length = static_cast<size_t>(kernelLength);
+        const auto centre = length / 2;
+
+        for (size_t k = 0; k < numSplits; ++k)
+        {
+            const auto fc = static_cast<double>(requestedCutoffs[k].load(std::memory_order_relaxed));
+
+            // Zero-phase magnitude on the kernel's own frequency grid...
+            std::fill(designSpectrum.begin(), designSpectrum.end(), SampleType());
+            for (size_t bin = 0; bin <= centre; ++bin)
+            {
+                const auto ratio = static_cast<double>(bin) * sampleRate / static_cast<double>(length) / fc;
+                designSpectrum[2 * bin] = static_cast<SampleType>(1.0 / (1.0 + ratio * ratio * ratio * ratio));
+            }
+
+            kernelFFT->performRealOnlyInverseTransform(designSpectrum.data());
+
+            // ...which comes back centred on sample 0; move it to the middle
+            // and taper the ends with a Hann window.
+            auto& lowpass = designLowpasses[k];
+            for (size_t n = 0; n < length; ++n)
+            {
+                const auto window = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * static_cast<double>(n) / static_cast<double>(length));
+                lowpass[n] = static_cast<SampleType>(window) * designSpectrum[(n + centre) % length];
+            }
+        }
+
+        const auto partitionBins = static_cast<std::ptrdiff_t>(binStride);
+
+        for (size_t band = 0; band < NumBands; ++band)
+        {
+            for (size_t n = 0; n < length; ++n)
+            {
+                const auto upper = band < numSplits ? designLowpasses[band][n] : (n == centre ? SampleType(1) : SampleType());
+                const auto lower = band > 0 ? designLowpasses[band - 1][n] : SampleType();
+                designKernel[n] = upper - lower;
+            }
+
+            for (size_t p = 0; p < numPartitions; ++p)
+            {
+                std::fill(designPartition.begin(), designPartition.end(), SampleType());
+                const auto start = designKernel.begin() + static_cast<std::ptrdiff_t>(p) * partitionSize;
+                std::copy(start, start + partitionSize, designPartition.begin());
+                partitionFFTForDesign->performRealOnlyForwardTransform(designPartition.data(), true);
+
+                auto* destPartition = dest.data() + (band * numPartitions + p) * binStride;
+                std::copy(designPartition.begin(), designPartition.begin() + partitionBins, destPartition);
+            }
+        }
+    }
+
+    class Designer : public juce::Thread
+    {
+    public:
+        explicit Designer (LinearPhaseCrossover& c)
+            : juce::Thread("Linear phase crossover"), crossover(c)
+        {
+        }
+
+        void run() override
+        {
+            // Polled rather than signalled, so the audio thread never touches a lock.
+            while (! threadShouldExit())
+            {
+                const auto serial = crossover.requestSerial.load(std::memory_order_acquire);
+
+                if (serial != crossover.designedSerial)
+                {
+                    crossover.designKernels(crossover.kernels[static_cast<size_t>(crossover.back)]);
+                    crossover.designedSerial = serial;
+                    crossover.back = crossover.pending.exchange(crossover.back | freshKernels, std::memory_order_acq_rel) & slotMask;
+                    continue;
+                }
+
+                wait(pollIntervalMs);
+            }
+        }
+
+    private:
+        static constexpr int pollIntervalMs = 5;
+
+        LinearPhaseCrossover& crossover;
+    };
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0;
+    int kernelLength = 0, partitionSize = maxPartitionSize;
+    size_t numPartitions = 0;
+
+    // (partitionSize + 1) complex bins, interleaved as JUCE's real-only FFT writes them.
+    size_t binStride = 2 * (maxPartitionSize + 1);
+
+    std::unique_ptr<RealFFT<SampleType>> partitionFFT;
+
+    // Audio thread
+    Cutoffs cutoff {};
+    std::vector<std::vector<SampleType>> inputFrames, delayLines;
+    std::array<std::vector<std::vector<SampleType>>, NumBands> outputs;
+    std::vector<SampleType> fftBuffer, fadeBuffer, accumulator, fadeIn;
+    int fifoPosition = 0;
+    size_t delayLinePosition = 0;
+    int front = 0, spare = 1, fadingFrom = -1;
+
+    // Shared
+    std::array<std::vector<SampleType>, 4> kernels;
+    std::array<std::atomic<float>, numSplits> requestedCutoffs {};
+    std::atomic<juce::uint32> requestSerial { 0 };
+    std::atomic<int> pending { 2 };
+
+    // Message thread
+    bool designerActive = false;
+
+    // Designer thread
+    juce::uint32 designedSerial = 0;
+    int back = 3;
+    std::unique_ptr<RealFFT<SampleType>> partitionFFTForDesign, kernelFFT;
+    std::vector<SampleType> designSpectrum, designKernel, designPartition;
+    std::vector<std::vector<SampleType>> designLowpasses;
+
+    Designer designer { *this };
+
+    JUCE_DECLARE_NON_COPYABLE (LinearPhaseCrossover)
+};
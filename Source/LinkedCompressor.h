@@ -0,0 +1,826 @@
+/*
+  ==============================================================================
+
+    LinkedCompressor.h
+    Created: 17 Oct 2026 4:04:55am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include "SIMDFrames.h"
+
+/** How the channels of a link group drive its gain. */
+enum class StereoLink
+{
+    Off,        // every channel has its own detector and gain
+    Max,        // the loudest channel drives one gain for all of them
+    Average     // the mean of the channels' levels drives one gain for all of them
+};
+
+/** Link group of every channel in a layout, for LinkedCompressor::setChannelGroups().
+    Fronts, surrounds and heights are linked among themselves, the LFEs are
+    never linked, and anything else (ambisonic components, discrete channels)
+    joins the fronts.
+*/
+inline std::vector<int> getChannelLinkGroups (const juce::AudioChannelSet& layout)
+{
+    enum { unlinked = -1, front = 0, surround = 1, height = 2 };
+
+    std::vector<int> groups;
+    groups.reserve(static_cast<size_t>(layout.size()));
+
+    for (int ch = 0; ch < layout.size(); ++ch)
+    {
+        switch (layout.getTypeOfChannel(ch))
+        {
+            case juce::AudioChannelSet::LFE:
+            case juce::AudioChannelSet::LFE2:
+                groups.push_back(unlinked);
+                break;
+
+            case juce::AudioChannelSet::leftSurround:
+            case juce::AudioChannelSet::rightSurround:
+            case juce::AudioChannelSet::centreSurround:
+            case juce::AudioChannelSet::leftSurroundSide:
+            case juce::AudioChannelSet::rightSurroundSide:
+            case juce::AudioChannelSet::leftSurroundRear:
+            case juce::AudioChannelSet::rightSurroundRear:
+                groups.push_back(surround);
+                break;
+
+            case juce::AudioChannelSet::topMiddle:
+            case juce::AudioChannelSet::topFrontLeft:
+            case juce::AudioChannelSet::topFrontCentre:
+            case juce::AudioChannelSet::topFrontRight:
+            case juce::AudioChannelSet::topRearLeft:
+            case juce::AudioChannelSet::topRearCentre:
+            case juce::AudioChannelSet::topRearRight:
+            case juce::AudioChannelSet::topSideLeft:
+            case juce::AudioChannelSet::topSideRight:
+                groups.push_back(height);
+                break;
+
+            default:
+                groups.push_back(front);
+                break;
+        }
+    }
+
+    return groups;
+}
+
+/*
+    Peak compressor with the same ballistics and gain curve as
+    juce::dsp::Compressor, so with StereoLink::Off, no knee and the
+    reference gain math its output is identical.
+    The channels can be linked in groups (all of them by default), in which
+    case each group has a single envelope follower and gain computation per
+    sample frame instead of one per channel.
+
+    Each block goes through four passes over a scratch buffer: rectify
+    (and combine a group's channels when linked), run the envelope, compute
+    the gain, and apply it. Only the envelope is a recurrence, so it is run
+    for several detectors at once, one per SIMD lane, with up to four
+    registers of them in flight to hide its latency; the other passes are
+    straight loops over contiguous samples.
+
+    The gain is computed in the log domain, where a soft knee is just a
+    clamp and a square: the hard knee is the same expression with a zero
+    knee width, so it costs nothing extra. By default the log2/exp2 come
+    from FastMath (within 0.00012 dB), a SIMD register of samples at a
+    time, for float and double; the reference path uses the standard
+    library and is kept to validate it.
+
+    With lookahead the detector still sees the incoming signal but the gain
+    is applied to the signal from lookahead samples ago, so the gain is
+    already down when a transient arrives. The delay line is a ring per
+    channel, allocated in prepare() for the longest lookahead: each block is
+    written into it once and the apply pass reads the delayed samples
+    straight out of it.
+*/
+template <typename SampleType>
+class LinkedCompressor
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr double maxLookaheadSeconds = 0.01;
+
+    static int getMaxLookaheadSamples (double rate) noexcept
+    {
+        return static_cast<int>(std::ceil(maxLookaheadSeconds * rate));
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert(spec.sampleRate > 0 && spec.numChannels > 0);
+
+        sampleRate = spec.sampleRate;
+        envelope.assign(spec.numChannels, SampleType(0));
+        handover.assign(spec.numChannels, SampleType(0));
+
+        // One row per envelope lane, plus one to combine linked channels in.
+        scratch.setSize(static_cast<int>(maxEnvelopeLanes) + 1, static_cast<int>(spec.maximumBlockSize));
+        buildDetectors(spec.numChannels);
+
+        // Room for the longest lookahead plus a whole block, so writing a block
+        // never overwrites samples that block still has to read.
+        maxLookahead = getMaxLookaheadSamples(sampleRate);
+        delayLine.setSize(static_cast<int>(spec.numChannels),
+                          maxLookahead + static_cast<int>(spec.maximumBlockSize));
+        lookahead = juce::jmin(lookahead, maxLookahead);
+
+        update();
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(envelope.begin(), envelope.end(), SampleType(0));
+        delayLine.clear();
+        writePosition = 0;
+    }
+
+    /** Moves the compressor to another rate without reallocating, e.g. to follow an
+        oversampling factor. prepare() must have been given at least this rate and
+        the largest block that will be processed at it. Resets the state.
+    */
+    void setSampleRate (double newSampleRate)
+    {
+        jassert(newSampleRate > 0);
+        jassert(getMaxLookaheadSamples(newSampleRate) + scratch.getNumSamples() <= delayLine.getNumSamples());
+
+        sampleRate = newSampleRate;
+        maxLookahead = getMaxLookaheadSamples(sampleRate);
+        lookahead = juce::jmin(lookahead, maxLookahead);
+
+        update();
+        reset();
+    }
+
+    /** Delay of the compressed signal behind the detector, up to getMaxLookaheadSamples(). */
+    void setLookahead (int numSamples) noexcept
+    {
+        numSamples = juce::jlimit(0, maxLookahead, numSamples);
+
+        // The ring isn't written while lookahead is off, so it holds stale audio.
+        if (lookahead == 0 && numSamples > 0)
+            delayLine.clear();
+
+        lookahead = numSamples;
+    }
+
+    int getLookahead() const noexcept
+    {
+        return lookahead;
+    }
+
+    void setThreshold (SampleType newThresholdDecibels)
+    {
+        thresholdDecibels = newThresholdDecibels;
+        updateThreshold();
+    }
+
+    void setRatio (SampleType newRatio)
+    {
+        jassert(newRatio >= SampleType(1));
+        ratio = newRatio;
+        ratioInverse = static_cast<SampleType>(1.0) / ratio;
+    }
+
+    void setAttack (SampleType newAttackMs)
+    {
+        attackMs = newAttackMs;
+        attackCoefficient = calculateCoefficient(attackMs);
+    }
+
+    void setRelease (SampleType newReleaseMs)
+    {
+        releaseMs = newReleaseMs;
+        releaseCoefficient = calculateCoefficient(releaseMs);
+    }
+
+    /** Width of the soft knee in dB, centred on the threshold. 0 is a hard knee. */
+    void setKnee (SampleType newKneeDecibels)
+    {
+        jassert(newKneeDecibels >= SampleType(0));
+        kneeDecibels = newKneeDecibels;
+        updateKnee();
+    }
+
+    void setUseReferenceGainMath (bool shouldUseReference) noexcept
+    {
+        useReferenceGainMath = shouldUseReference;
+    }
+
+    /** What the envelope and the gain computer actually run on: threshold
+        and knee in octaves of level, attack and release as the envelope's
+        one-pole coefficients. The setters derive these with exp and log; a
+        parameter ramp moves them directly instead.
+    */
+    struct Coefficients
+    {
+        SampleType log2Threshold = 0, kneeOctaves = 0, attack = 0, release = 0;
+    };
+
+    Coefficients getCoefficients() const noexcept
+    {
+        return { log2Threshold, kneeOctaves, attackCoefficient, releaseCoefficient };
+    }
+
+    /** The coefficients the setters would give these values at the current sample rate. */
+    Coefficients calculateCoefficients (SampleType newThresholdDecibels, SampleType newKneeDecibels,
+                                        SampleType newAttackMs, SampleType newReleaseMs) const
+    {
+        return { std::log2(juce::Decibels::decibelsToGain(newThresholdDecibels, static_cast<SampleType>(-200.0))),
+                 decibelsToOctaves(newKneeDecibels),
+                 calculateCoefficient(newAttackMs),
+                 calculateCoefficient(newReleaseMs) };
+    }
+
+    /** Runs on these coefficients until the next setter call or sample rate
+        change. The values the setters were given are kept, so a ramp has to
+        end by calling the setters with its target. No exp or log.
+    */
+    void setCoefficients (const Coefficients& c) noexcept
+    {
+        if (c.log2Threshold != log2Threshold)
+        {
+            log2Threshold = c.log2Threshold;
+            thresholdIsStale = true;
+        }
+
+        kneeOctaves = c.kneeOctaves;
+        updateKneeShape();
+
+        attackCoefficient = c.attack;
+        releaseCoefficient = c.release;
+    }
+
+    /** Turns envelope levels into gains, in place. process() calls this for
+        every detector; it is public so the gain math can be timed on its own.
+    */
+    void computeGain (SampleType* data, size_t numSamples) noexcept
+    {
+        if ( useReferenceGainMath )
+            computeGainReference(data, numSamples);
+        else
+            computeGainFast(data, numSamples);
+    }
+
+    /** Which channels share a detector when linked: channels with the same
+        non-negative group are linked, a channel in group -1 is never linked.
+        Channels beyond the end are in group 0. Takes effect at the next prepare().
+    */
+    void setChannelGroups (std::vector<int> groups)
+    {
+        channelGroups = std::move(groups);
+    }
+
+    void setStereoLink (StereoLink newLink)
+    {
+        // Hand the detector state over so the gain doesn't jump: a group starts
+        // from its loudest channel, unlinked channels start from their group's.
+        if (link == StereoLink::Off && newLink != StereoLink::Off && ! envelope.empty())
+        {
+            for (size_t d = 0; d < linkedDetectors.getNumDetectors(); ++d)
+            {
+                handover[d] = SampleType(0);
+                for (auto i = linkedDetectors.offsets[d]; i < linkedDetectors.offsets[d + 1]; ++i)
+                    handover[d] = juce::jmax(handover[d], envelope[linkedDetectors.channels[i]]);
+            }
+
+            std::copy(handover.begin(), handover.end(), envelope.begin());
+        }
+        else if (link != StereoLink::Off && newLink == StereoLink::Off && ! envelope.empty())
+        {
+            for (size_t d = 0; d < linkedDetectors.getNumDetectors(); ++d)
+                for (auto i = linkedDetectors.offsets[d]; i < linkedDetectors.offsets[d + 1]; ++i)
+                    handover[linkedDetectors.channels[i]] = envelope[d];
+
+            std::copy(handover.begin(), handover.end(), envelope.begin());
+        }
+
+        link = newLink;
+    }
+
+    /** With a key, the detectors listen to it instead of the input: key channel
+        ch % key.getNumChannels() stands in for channel ch. The gain is still
+        applied to the input.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, juce::dsp::AudioBlock<const SampleType> key = {}) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        const auto numChannels = outputBlock.getNumChannels();
+        const auto numSamples = outputBlock.getNumSamples();
+
+        jassert(inputBlock.getNumChannels() == numChannels);
+        jassert(inputBlock.getNumSamples() == numSamples);
+        jassert(numChannels <= envelope.size());
+        jassert(numSamples <= static_cast<size_t>(scratch.getNumSamples()));
+        jassert(key.getNumChannels() == 0 || key.getNumSamples() == numSamples);
+
+        const auto n = static_cast<int>(numSamples);
+
+        if (context.isBypassed)
+        {
+            // Still delayed, so a bypassed band stays aligned with the others.
+            if (lookahead > 0)
+            {
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                    applyGain(ch, inputBlock.getChannelPointer(ch), outputBlock.getChannelPointer(ch), nullptr, n);
+
+                advanceDelayLine(n);
+            }
+            else if (context.usesSeparateInputAndOutputBlocks())
+            {
+                outputBlock.copyFrom(inputBlock);
+            }
+
+            return;
+        }
+
+        const auto& detectors = getDetectors();
+
+        runDetectors(inputBlock, key, [&] (size_t detector, SampleType* g)
+        {
+            computeGain(g, numSamples);
+
+            for (auto i = detectors.offsets[detector]; i < detectors.offsets[detector + 1]; ++i)
+            {
+                const auto ch = detectors.channels[i];
+                if (ch < numChannels)
+                    applyGain(ch, inputBlock.getChannelPointer(ch), outputBlock.getChannelPointer(ch), g, n);
+            }
+        });
+
+        advanceDelayLine(n);
+        snapEnvelopesToZero();
+    }
+
+    /** Moves the envelopes and the delay line on by the block exactly as
+        process() would, but computes and applies no gain and writes no
+        output. For a band nobody is listening to: when it is heard again it
+        carries on from where it would have been.
+    */
+    void track (juce::dsp::AudioBlock<const SampleType> inputBlock, bool isBypassed,
+                juce::dsp::AudioBlock<const SampleType> key = {}) noexcept
+    {
+        const auto numSamples = inputBlock.getNumSamples();
+        const auto n = static_cast<int>(numSamples);
+
+        jassert(inputBlock.getNumChannels() <= envelope.size());
+        jassert(numSamples <= static_cast<size_t>(scratch.getNumSamples()));
+
+        if (lookahead > 0)
+            for (size_t ch = 0; ch < inputBlock.getNumChannels(); ++ch)
+                writeDelayLine(ch, inputBlock.getChannelPointer(ch), n);
+
+        // A bypassed process() leaves the envelopes alone as well.
+        if (! isBypassed)
+        {
+            runDetectors(inputBlock, key, [] (size_t, SampleType*) {});
+            snapEnvelopesToZero();
+        }
+
+        advanceDelayLine(n);
+    }
+
+private:
+    /** The channels of every detector: those of detector d are
+        channels[offsets[d]] .. channels[offsets[d + 1] - 1].
+    */
+    struct DetectorMap
+    {
+        std::vector<size_t> channels, offsets;
+
+        size_t getNumDetectors() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+    };
+
+    const DetectorMap& getDetectors() const noexcept
+    {
+        return link == StereoLink::Off ? unlinkedDetectors : linkedDetectors;
+    }
+
+    // The envelope pass advances up to this many registers of detectors at
+    // once, and works through the block in tiles of envelopeTileSize frames.
+    static constexpr size_t maxEnvelopeRegisters = 4;
+    static constexpr size_t maxEnvelopeLanes = maxEnvelopeRegisters * Vec::size();
+    static constexpr size_t envelopeTileSize = 64;
+
+    // Rectifies and runs the envelope of every detector with a channel in
+    // the block, up to maxEnvelopeLanes at a time, then hands each detector's
+    // envelope row in the scratch buffer to useEnvelope.
+    template <typename UseEnvelope>
+    void runDetectors (const juce::dsp::AudioBlock<const SampleType>& inputBlock, juce::dsp::AudioBlock<const SampleType> key,
+                       UseEnvelope&& useEnvelope) noexcept
+    {
+        const auto& detectors = getDetectors();
+        const auto numChannels = inputBlock.getNumChannels();
+        const auto numSamples = inputBlock.getNumSamples();
+        const auto detectorInput = key.getNumChannels() > 0 ? key : inputBlock;
+        size_t d = 0;
+
+        while (d < detectors.getNumDetectors())
+        {
+            // Fill the lanes with the next detectors that have a channel in this block.
+            size_t laneDetectors[maxEnvelopeLanes] {};
+            size_t numLanes = 0;
+
+            for (; d < detectors.getNumDetectors() && numLanes < maxEnvelopeLanes; ++d)
+                if (rectify(detectors, d, detectorInput, numChannels, scratch.getWritePointer(static_cast<int>(numLanes)), static_cast<int>(numSamples)))
+                    laneDetectors[numLanes++] = d;
+
+            runEnvelopes(laneDetectors, numLanes, numSamples);
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+                useEnvelope(laneDetectors[lane], scratch.getWritePointer(static_cast<int>(lane)));
+        }
+    }
+
+    void snapEnvelopesToZero() noexcept
+    {
+       #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+        for (auto& e : envelope)
+            juce::dsp::util::snapToZero(e);
+       #endif
+    }
+
+    void buildDetectors (size_t numChannels)
+    {
+        unlinkedDetectors.channels.resize(numChannels);
+        unlinkedDetectors.offsets.resize(numChannels + 1);
+        std::iota(unlinkedDetectors.channels.begin(), unlinkedDetectors.channels.end(), size_t(0));
+        std::iota(unlinkedDetectors.offsets.begin(), unlinkedDetectors.offsets.end(), size_t(0));
+
+        // Every never-linked channel gets a key of its own; detectors are in
+        // the order of their first channel.
+        std::vector<int> keys (numChannels);
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            const auto group = ch < channelGroups.size() ? channelGroups[ch] : 0;
+            keys[ch] = group >= 0 ? group : -1 - static_cast<int>(ch);
+        }
+
+        linkedDetectors.channels.clear();
+        linkedDetectors.offsets.assign(1, 0);
+
+        for (size_t first = 0; first < numChannels; ++first)
+        {
+            if (std::find(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(first), keys[first])
+                    != keys.begin() + static_cast<std::ptrdiff_t>(first))
+                continue;
+
+            for (size_t ch = first; ch < numChannels; ++ch)
+                if (keys[ch] == keys[first])
+                    linkedDetectors.channels.push_back(ch);
+
+            linkedDetectors.offsets.push_back(linkedDetectors.channels.size());
+        }
+    }
+
+    // Writes the detector's level into dest: the rectified channel, or the
+    // max or mean of its rectified channels. False if none is in the block.
+    bool rectify (const DetectorMap& detectors, size_t d, const juce::dsp::AudioBlock<const SampleType>& input,
+                  size_t numChannels, SampleType* dest, int numSamples) noexcept
+    {
+        const auto numInputChannels = input.getNumChannels();
+        auto* spare = scratch.getWritePointer(static_cast<int>(maxEnvelopeLanes));
+        int count = 0;
+
+        for (auto i = detectors.offsets[d]; i < detectors.offsets[d + 1]; ++i)
+        {
+            const auto ch = detectors.channels[i];
+            if (ch >= numChannels)
+                continue;
+
+            const auto* in = input.getChannelPointer(ch % numInputChannels);
+
+            if (count++ == 0)
+            {
+                juce::FloatVectorOperations::abs(dest, in, numSamples);
+                continue;
+            }
+
+            juce::FloatVectorOperations::abs(spare, in, numSamples);
+
+            if (link == StereoLink::Max)
+                juce::FloatVectorOperations::max(dest, dest, spare, numSamples);
+            else
+                juce::FloatVectorOperations::add(dest, spare, numSamples);
+        }
+
+        if (count > 1 && link == StereoLink::Average)
+            juce::FloatVectorOperations::multiply(dest, SampleType(1) / static_cast<SampleType>(count), numSamples);
+
+        return count > 0;
+    }
+
+    // out = in * g without lookahead. With it, in goes into the channel's ring
+    // and out is the delayed signal read back from the ring times g, which is
+    // safe when in and out are the same buffer. A null g applies no gain.
+    void applyGain (size_t ch, const SampleType* in, SampleType* out, const SampleType* g, int numSamples) noexcept
+    {
+        if (lookahead == 0)
+        {
+            if (g != nullptr)
+                juce::FloatVectorOperations::multiply(out, in, g, numSamples);
+            else if (out != in)
+                juce::FloatVectorOperations::copy(out, in, numSamples);
+
+            return;
+        }
+
+        writeDelayLine(ch, in, numSamples);
+
+        const auto size = delayLine.getNumSamples();
+        const auto* ring = delayLine.getReadPointer(static_cast<int>(ch));
+        const auto readPosition = (writePosition + size - lookahead) % size;
+        const auto numToRead = juce::jmin(numSamples, size - readPosition);
+
+        if (g != nullptr)
+        {
+            juce::FloatVectorOperations::multiply(out, ring + readPosition, g, numToRead);
+            juce::FloatVectorOperations::multiply(out + numToRead, ring, g + numToRead, numSamples - numToRead);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(out, ring + readPosition, numToRead);
+            juce::FloatVectorOperations::copy(out + numToRead, ring, numSamples - numToRead);
+        }
+    }
+
+    // Puts the block into the channel's ring at the write position, which
+    // advanceDelayLine() moves on once every channel has been written.
+    void writeDelayLine (size_t ch, const SampleType* in, int numSamples) noexcept
+    {
+        const auto size = delayLine.getNumSamples();
+        auto* ring = delayLine.getWritePointer(static_cast<int>(ch));
+
+        const auto numToEnd = juce::jmin(numSamples, size - writePosition);
+        juce::FloatVectorOperations::copy(ring + writePosition, in, numToEnd);
+        juce::FloatVectorOperations::copy(ring, in + numToEnd, numSamples - numToEnd);
+    }
+
+    void advanceDelayLine (int numSamples) noexcept
+    {
+        if (lookahead > 0)
+            writePosition = (writePosition + numSamples) % delayLine.getNumSamples();
+    }
+
+    // Peak ballistics, as juce::dsp::BallisticsFilter, in place over one detector's levels.
+    void runEnvelope (SampleType& state, SampleType* level, size_t numSamples) noexcept
+    {
+        auto y = state;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto x = level[i];
+            const auto cte = x > y ? attackCoefficient : releaseCoefficient;
+            y = x + cte * (y - x);
+            level[i] = y;
+        }
+
+        state = y;
+    }
+
+    // The same recurrence for the detectors in the scratch rows, one per lane.
+    // Each lane gives exactly what runEnvelope does. Both x + attack (y - x)
+    // and x + release (y - x) are computed; rounding is monotonic, so with
+    // attack <= release the attack one is the larger exactly when x > y, and
+    // a max picks it (a min when attack > release). That keeps the compare
+    // and mask off the recurrence's critical path.
+    void runEnvelopes (const size_t* detectors, size_t numLanes, size_t numSamples) noexcept
+    {
+        if (numLanes == 1)
+            runEnvelope(envelope[detectors[0]], scratch.getWritePointer(0), numSamples);
+
+        if (numLanes <= 1)
+            return;
+
+        switch ((numLanes + Vec::size() - 1) / Vec::size())
+        {
+            case 1:  runEnvelopes<1>(detectors, numLanes, numSamples); break;
+            case 2:  runEnvelopes<2>(detectors, numLanes, numSamples); break;
+            case 3:  runEnvelopes<3>(detectors, numLanes, numSamples); break;
+            default: runEnvelopes<maxEnvelopeRegisters>(detectors, numLanes, numSamples); break;
+        }
+    }
+
+    // The recurrence is bound by its latency, not by its arithmetic, so
+    // several registers of detectors are advanced in the same loop and
+    // their dependency chains overlap. The rows are interleaved a tile at
+    // a time, so each register is a single load and store per frame.
+    template <size_t NumRegisters>
+    void runEnvelopes (const size_t* detectors, size_t numLanes, size_t numSamples) noexcept
+    {
+        jassert(numLanes > (NumRegisters - 1) * Vec::size() && numLanes <= NumRegisters * Vec::size());
+
+        alignas(Vec::SIMDRegisterSize) SampleType frames[NumRegisters][envelopeTileSize * Vec::size()];
+        alignas(Vec::SIMDRegisterSize) SampleType lanes[NumRegisters * Vec::size()] = {};
+        SampleType* rows[NumRegisters * Vec::size()] {};
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            rows[lane] = scratch.getWritePointer(static_cast<int>(lane));
+            lanes[lane] = envelope[detectors[lane]];
+        }
+
+        const auto attack = Vec::expand(attackCoefficient);
+        const auto release = Vec::expand(releaseCoefficient);
+        const auto attackIsFaster = attackCoefficient <= releaseCoefficient;
+
+        std::array<Vec, NumRegisters> y;
+        for (size_t r = 0; r < NumRegisters; ++r)
+            y[r] = Vec::fromRawArray(lanes + r * Vec::size());
+
+        auto getNumLanes = [numLanes] (size_t r) { return juce::jmin(Vec::size(), numLanes - r * Vec::size()); };
+
+        for (size_t start = 0; start < numSamples; start += envelopeTileSize)
+        {
+            const auto length = juce::jmin(envelopeTileSize, numSamples - start);
+
+            for (size_t r = 0; r < NumRegisters; ++r)
+                SIMDFrames::interleave(rows + r * Vec::size(), getNumLanes(r), start, length, frames[r]);
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                for (size_t r = 0; r < NumRegisters; ++r)
+                {
+                    auto* frame = frames[r] + i * Vec::size();
+                    const auto x = Vec::fromRawArray(frame);
+                    const auto d = y[r] - x;
+                    y[r] = attackIsFaster ? Vec::max(x + attack * d, x + release * d) : Vec::min(x + attack * d, x + release * d);
+                    y[r].copyToRawArray(frame);
+                }
+            }
+
+            for (size_t r = 0; r < NumRegisters; ++r)
+                SIMDFrames::deinterleave(frames[r], length, rows + r * Vec::size(), getNumLanes(r), start);
+        }
+
+        for (size_t r = 0; r < NumRegisters; ++r)
+            y[r].copyToRawArray(lanes + r * Vec::size());
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            envelope[detectors[lane]] = lanes[lane];
+    }
+
+    // Overshoot x in octaves above the threshold; the gain in octaves is
+    // slope * x above the knee, a parabola inside it and 0 below it.
+    static inline SampleType gainInOctaves (SampleType x, SampleType slope, SampleType halfKnee,
+                                            SampleType knee, SampleType inverseTwoKnee) noexcept
+    {
+        const auto t = std::min(std::max(x + halfKnee, SampleType(0)), knee);
+        return slope * (t * t * inverseTwoKnee + std::max(x - halfKnee, SampleType(0)));
+    }
+
+    // gainInOctaves for a whole register of levels at once.
+    struct GainComputer
+    {
+        Vec log2Threshold, slope, halfKnee, knee, inverseTwoKnee, kneeStart;
+
+        Vec operator() (Vec level) const noexcept
+        {
+            // Below the knee the gain is exactly 1. Envelopes sit there for
+            // long stretches, so a whole register of it skips the math.
+            if (Vec::greaterThan(level, kneeStart) == 0)
+                return Vec::expand(SampleType(1));
+
+            const auto zero = Vec::expand(SampleType(0));
+            const auto x = FastMath::log2(level) - log2Threshold;
+            const auto t = Vec::min(Vec::max(x + halfKnee, zero), knee);
+            return FastMath::exp2(slope * (t * t * inverseTwoKnee + Vec::max(x - halfKnee, zero)));
+        }
+    };
+
+    void computeGainFast (SampleType* data, size_t numSamples) noexcept
+    {
+        const GainComputer gain { Vec::expand(log2Threshold), Vec::expand(ratioInverse - SampleType(1)),
+                                  Vec::expand(halfKneeOctaves), Vec::expand(kneeOctaves), Vec::expand(inverseTwoKneeOctaves),
+                                  FastMath::exp2(Vec::expand(log2Threshold - halfKneeOctaves)) };
+
+        // The body is loaded straight from the row; the unaligned head and
+        // the tail go through a register's worth of stack.
+        const auto head = juce::jmin(numSamples, static_cast<size_t>(Vec::getNextSIMDAlignedPtr(data) - data));
+        computeGainPartial(gain, data, head);
+
+        auto i = head;
+        for (; i + Vec::size() <= numSamples; i += Vec::size())
+            gain(Vec::fromRawArray(data + i)).copyToRawArray(data + i);
+
+        computeGainPartial(gain, data + i, numSamples - i);
+    }
+
+    static void computeGainPartial (const GainComputer& gain, SampleType* data, size_t numSamples) noexcept
+    {
+        if (numSamples == 0)
+            return;
+
+        alignas(Vec::SIMDRegisterSize) SampleType lanes[Vec::size()] = {};
+        std::copy(data, data + numSamples, lanes);
+        gain(Vec::fromRawArray(lanes)).copyToRawArray(lanes);
+        std::copy(lanes, lanes + numSamples, data);
+    }
+
+    void computeGainReference (SampleType* data, size_t numSamples) noexcept
+    {
+        const auto slope = ratioInverse - SampleType(1);
+
+        if (kneeOctaves <= SampleType(0))
+        {
+            if (thresholdIsStale)
+            {
+                threshold = std::exp2(log2Threshold);
+                thresholdInverse = SampleType(1) / threshold;
+                thresholdIsStale = false;
+            }
+
+            // Exactly juce::dsp::Compressor's VCA.
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto env = data[i];
+                data[i] = env < threshold ? SampleType(1) : std::pow(env * thresholdInverse, slope);
+            }
+
+            return;
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto x = std::log2(std::max(data[i], std::numeric_limits<SampleType>::min())) - log2Threshold;
+            data[i] = std::exp2(gainInOctaves(x, slope, halfKneeOctaves, kneeOctaves, inverseTwoKneeOctaves));
+        }
+    }
+
+    SampleType calculateCoefficient (SampleType timeMs) const
+    {
+        const auto expFactor = -2.0 * juce::MathConstants<double>::pi * 1000.0 / sampleRate;
+        return timeMs < static_cast<SampleType>(1.0e-3) ? SampleType(0)
+                                                        : static_cast<SampleType>(std::exp(expFactor / timeMs));
+    }
+
+    // Each setter only recomputes what depends on its own value, so a
+    // parameter ramp that moves one of them per step stays cheap.
+    void updateThreshold()
+    {
+        threshold = juce::Decibels::decibelsToGain(thresholdDecibels, static_cast<SampleType>(-200.0));
+        thresholdInverse = static_cast<SampleType>(1.0) / threshold;
+        log2Threshold = std::log2(threshold);
+        thresholdIsStale = false;
+    }
+
+    void updateKnee()
+    {
+        kneeOctaves = decibelsToOctaves(kneeDecibels);
+        updateKneeShape();
+    }
+
+    // Octaves of level: 20 * log10(2) dB per octave.
+    static SampleType decibelsToOctaves (SampleType decibels) noexcept
+    {
+        return decibels / static_cast<SampleType>(20.0 * std::log10(2.0));
+    }
+
+    void updateKneeShape() noexcept
+    {
+        halfKneeOctaves = kneeOctaves / SampleType(2);
+        inverseTwoKneeOctaves = kneeOctaves > SampleType(0) ? SampleType(1) / (SampleType(2) * kneeOctaves) : SampleType(0);
+    }
+
+    // Everything, e.g. after the sample rate changed.
+    void update()
+    {
+        updateThreshold();
+        updateKnee();
+        ratioInverse = static_cast<SampleType>(1.0) / ratio;
+        attackCoefficient = calculateCoefficient(attackMs);
+        releaseCoefficient = calculateCoefficient(releaseMs);
+    }
+
+    double sampleRate = 44100.0;
+    SampleType thresholdDecibels = 0, ratio = 1, attackMs = 1, releaseMs = 100;
+    SampleType kneeDecibels = 0;
+    SampleType threshold = 1, thresholdInverse = 1, ratioInverse = 1, log2Threshold = 0;
+    bool thresholdIsStale = false;  // threshold and thresholdInverse, after setCoefficients()
+    SampleType kneeOctaves = 0, halfKneeOctaves = 0, inverseTwoKneeOctaves = 0;
+    bool useReferenceGainMath = false;
+    SampleType attackCoefficient = 0, releaseCoefficient = 0;
+    StereoLink link = StereoLink::Off;
+
+    // Indexed by detector, which is the channel when unlinked.
+    std::vector<SampleType> envelope, handover;
+    juce::AudioBuffer<SampleType> scratch;
+
+    std::vector<int> channelGroups;
+    DetectorMap unlinkedDetectors, linkedDetectors;
+
+    juce::AudioBuffer<SampleType> delayLine;
+    int writePosition = 0, lookahead = 0, maxLookahead = 0;
+};
@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    Metering.h
+    Created: 17 Oct 2026 4:03:09am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Peak and mean square of everything added since the last clear(), over
+    all channels. Filled on the audio thread, read on the message thread
+    after it came through a MeterFifo.
+*/
+struct LevelAccumulator
+{
+    float peak = 0.f;
+    double sumSquares = 0.0;
+    juce::uint32 numValues = 0;
+
+    void add (const juce::dsp::AudioBlock<const float>& block) noexcept
+    {
+        addChannels(block);
+    }
+
+    void add (const juce::dsp::AudioBlock<const double>& block) noexcept
+    {
+        addChannels(block);
+    }
+
+    /** Sums in the sample type; only the block's totals are narrowed or widened. */
+    template <typename SampleType>
+    void add (const SampleType* data, size_t numSamples) noexcept
+    {
+        // Eight independent lanes, so the compiler can turn the loop body
+        // into plain SIMD max/mul/add without reassociating anything.
+        constexpr size_t numLanes = 8;
+        SampleType lanePeak[numLanes] = {};
+        SampleType laneSum[numLanes] = {};
+
+        size_t i = 0;
+        for (; i + numLanes <= numSamples; i += numLanes)
+        {
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                const auto x = data[i + lane];
+                const auto magnitude = std::abs(x);
+                lanePeak[lane] = lanePeak[lane] < magnitude ? magnitude : lanePeak[lane];
+                laneSum[lane] += x * x;
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            lanePeak[0] = juce::jmax(lanePeak[0], std::abs(data[i]));
+            laneSum[0] += data[i] * data[i];
+        }
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            peak = juce::jmax(peak, static_cast<float>(lanePeak[lane]));
+            sumSquares += static_cast<double>(laneSum[lane]);
+        }
+
+        numValues += static_cast<juce::uint32>(numSamples);
+    }
+
+    void merge (const LevelAccumulator& other) noexcept
+    {
+        peak = juce::jmax(peak, other.peak);
+        sumSquares += other.sumSquares;
+        numValues += other.numValues;
+    }
+
+    void clear() noexcept
+    {
+        *this = {};
+    }
+
+    template <typename SampleType>
+    void addChannels (const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+    {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            add(block.getChannelPointer(ch), block.getNumSamples());
+    }
+
+    float getPeakDecibels() const noexcept
+    {
+        return juce::Decibels::gainToDecibels(peak);
+    }
+
+    float getRmsDecibels() const noexcept
+    {
+        if (numValues == 0)
+            return juce::Decibels::gainToDecibels(0.f);
+
+        return juce::Decibels::gainToDecibels(static_cast<float>(std::sqrt(sumSquares / numValues)));
+    }
+};
+
+/*
+    Everything the editor displays, for one stretch of audio. The gain
+    reduction of a band is the ratio of its output to its input power, so
+    it needs nothing from inside the compressor.
+*/
+template <size_t NumBands>
+struct MeterFrame
+{
+    LevelAccumulator input, output;
+    std::array<LevelAccumulator, NumBands> bandInput, bandOutput;
+    juce::uint32 numSamples = 0;
+
+    void merge (const MeterFrame& other) noexcept
+    {
+        input.merge(other.input);
+        output.merge(other.output);
+
+        for (size_t i = 0; i < NumBands; ++i)
+        {
+            bandInput[i].merge(other.bandInput[i]);
+            bandOutput[i].merge(other.bandOutput[i]);
+        }
+
+        numSamples += other.numSamples;
+    }
+
+    void clear() noexcept
+    {
+        *this = {};
+    }
+
+    /** Zero or negative; 0 dB when the band was silent. */
+    float getGainReductionDecibels (size_t band) const noexcept
+    {
+        const auto in = bandInput[band].sumSquares;
+        const auto out = bandOutput[band].sumSquares;
+
+        if (in <= 0.0 || out <= 0.0)
+            return 0.f;
+
+        return juce::jmin(0.f, static_cast<float>(10.0 * std::log10(out / in)));
+    }
+};
+
+/*
+    Single producer, single consumer queue of meter frames. push() never
+    waits: when the reader has fallen behind (or no editor is open) the
+    frame is dropped.
+*/
+template <typename Frame, int Capacity>
+class MeterFifo
+{
+public:
+    bool push (const Frame& frame) noexcept
+    {
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return false;
+
+        frames[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = frame;
+        return true;
+    }
+
+    /** Merges every queued frame into dest. Returns false if there were none. */
+    bool pullAll (Frame& dest) noexcept
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+
+        for (int i = 0; i < scope.blockSize1; ++i)
+            dest.merge(frames[static_cast<size_t>(scope.startIndex1 + i)]);
+
+        for (int i = 0; i < scope.blockSize2; ++i)
+            dest.merge(frames[static_cast<size_t>(scope.startIndex2 + i)]);
+
+        return scope.blockSize1 + scope.blockSize2 > 0;
+    }
+
+private:
+    juce::AbstractFifo fifo { Capacity };
+    std::array<Frame, Capacity> frames;
+};
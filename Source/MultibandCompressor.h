@@ -0,0 +1,818 @@
+/*
+  ==============================================================================
+
+    MultibandCompressor.h
+    Created: 17 Oct 2026 3:55:08am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "BandWorkerPool.h"
+#include "CompressorBand.h"
+#include "Crossover.h"
+#include "LinearPhaseCrossover.h"
+#include "Metering.h"
+#include "ParameterChangeFlag.h"
+#include "ParamInfo.h"
+#include "SnapshotMorph.h"
+#include "StageProfile.h"
+
+/*
+    The band split, per-band compressors and band summation for a fixed band
+    count. Everything that depends on the number of bands (crossover tree,
+    compressor array, band storage and parameter table) is sized from
+    NumBands at compile time.
+
+    SampleType is float or double. The parameters are the same for both, so
+    the static parameter functions can be called on either.
+*/
+template <size_t NumBands, typename SampleType = float>
+class MultibandCompressor
+{
+public:
+    static_assert(NumBands >= 2, "A multiband compressor needs at least two bands");
+
+    static constexpr size_t numBands = NumBands;
+    static constexpr size_t numSplits = NumBands - 1;
+
+    using APVTS = juce::AudioProcessorValueTreeState;
+
+    static void addParameters (APVTS::ParameterLayout& layout)
+    {
+        using namespace Params;
+
+        auto addFloat = [&layout](const juce::String& name, juce::NormalisableRange<float> range, float defaultValue)
+        {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(name, name, range, defaultValue));
+        };
+
+        auto addBool = [&layout](const juce::String& name)
+        {
+            layout.add(std::make_unique<juce::AudioParameterBool>(name, name, false));
+        };
+
+        auto attackReleaseRange = juce::NormalisableRange<float>( 5.f, 500.f, 1.f, 1.f );
+
+        juce::StringArray strArray;
+        for (auto ratio : RatioChoices)
+        {
+            strArray.add(juce::String(ratio, 1));
+        }
+
+        for (auto param : AllBandParams)
+        {
+            for (size_t band = 0; band < NumBands; ++band)
+            {
+                auto name = GetBandParamName<NumBands>(param, band);
+
+                switch (param)
+                {
+                    case BandParam::Threshold:
+                        addFloat(name, juce::NormalisableRange<float>(-60.f, 12.f, 1.f, 1.f), 0.f);
+                        break;
+                    case BandParam::Attack:
+                        addFloat(name, attackReleaseRange, 50.f);
+                        break;
+                    case BandParam::Release:
+                        addFloat(name, attackReleaseRange, 250.f);
+                        break;
+                    case BandParam::Ratio:
+                        layout.add(std::make_unique<juce::AudioParameterChoice>(name, name, strArray, 2));
+                        break;
+                    case BandParam::Bypassed:
+                    case BandParam::Mute:
+                    case BandParam::Solo:
+                        addBool(name);
+                        break;
+                    case BandParam::Knee:
+                    case BandParam::Sidechain:
+                        // Added by addLateParameters().
+                        jassertfalse;
+                        break;
+                }
+            }
+        }
+
+        for (size_t split = 0; split < numSplits; ++split)
+        {
+            auto range = GetCrossoverRange<NumBands>(split);
+            addFloat(GetCrossoverParamName<NumBands>(split),
+                     juce::NormalisableRange<float>(range.minimum, range.maximum, 1.f, 1.f),
+                     range.defaultValue);
+        }
+    }
+
+    /** Parameters that were added to the plugin later. The processor adds these
+        after all the others, so the existing parameters keep their indices.
+    */
+    static void addLateParameters (APVTS::ParameterLayout& layout)
+    {
+        using namespace Params;
+
+        // Off by default so existing sessions sound the same.
+        const auto& linkName = GetParams().at(Names::Stereo_Link);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(linkName, linkName,
+                                                                juce::StringArray { "Off", "Max", "Average" }, 0));
+
+        for (auto param : LateBandParams)
+        {
+            for (size_t band = 0; band < NumBands; ++band)
+            {
+                auto name = GetBandParamName<NumBands>(param, band);
+
+                switch (param)
+                {
+                    case BandParam::Knee:
+                        layout.add(std::make_unique<juce::AudioParameterFloat>(name, name, juce::NormalisableRange<float>(0.f, 24.f, 0.5f, 1.f), 0.f));
+                        break;
+                    default:
+                        jassertfalse;
+                        break;
+                }
+            }
+        }
+
+        // Global rather than per band: the bands are summed, so they all need the same delay.
+        const auto& lookaheadName = GetParams().at(Names::Lookahead);
+        const auto maxLookaheadMs = static_cast<float>(LinkedCompressor<SampleType>::maxLookaheadSeconds * 1000.0);
+        layout.add(std::make_unique<juce::AudioParameterFloat>(lookaheadName, lookaheadName,
+                                                               juce::NormalisableRange<float>(0.f, maxLookaheadMs, 0.1f, 1.f), 0.f));
+
+        // Global for the same reason: every band has to go through the same resampling filters.
+        const auto& oversamplingName = GetParams().at(Names::Oversampling);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(oversamplingName, oversamplingName,
+                                                                juce::StringArray { "Off", "2x", "4x", "8x" }, 0));
+
+        const auto& qualityName = GetParams().at(Names::Oversampling_Quality);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(qualityName, qualityName,
+                                                                juce::StringArray { "Low Latency", "High Quality", "Linear Phase" }, 0));
+
+        const auto& crossoverModeName = GetParams().at(Names::Crossover_Mode);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(crossoverModeName, crossoverModeName,
+                                                                juce::StringArray { "Minimum Phase", "Linear Phase" }, 0));
+
+        // Off by default: a band only listens to the sidechain when asked to.
+        for (size_t band = 0; band < NumBands; ++band)
+        {
+            auto name = GetBandParamName<NumBands>(BandParam::Sidechain, band);
+            layout.add(std::make_unique<juce::AudioParameterBool>(name, name, false));
+        }
+    }
+
+    void attachParameters (APVTS& apvts)
+    {
+        using namespace Params;
+
+        auto floatHelper = [&apvts](auto& param, const juce::String& paramName)
+        {
+            param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(paramName));
+            jassert(param != nullptr);
+        };
+
+        auto choiceHelper = [&apvts](auto& param, const juce::String& paramName)
+        {
+            param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramName));
+            jassert(param != nullptr);
+        };
+
+        auto boolHelper = [&apvts](auto& param, const juce::String& paramName)
+        {
+            param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(paramName));
+            jassert(param != nullptr);
+        };
+
+        const auto& linkName = GetParams().at(Names::Stereo_Link);
+        const auto& lookaheadName = GetParams().at(Names::Lookahead);
+        floatHelper(lookaheadParam, lookaheadName);
+        const auto& oversamplingName = GetParams().at(Names::Oversampling);
+        choiceHelper(oversamplingParam, oversamplingName);
+        const auto& qualityName = GetParams().at(Names::Oversampling_Quality);
+        choiceHelper(oversamplingQualityParam, qualityName);
+        const auto& crossoverModeName = GetParams().at(Names::Crossover_Mode);
+        choiceHelper(crossoverModeParam, crossoverModeName);
+
+        for (size_t band = 0; band < NumBands; ++band)
+        {
+            auto& comp = compressors[band];
+            auto name = [band](BandParam p) { return GetBandParamName<NumBands>(p, band); };
+
+            floatHelper(comp.attack, name(BandParam::Attack));
+            floatHelper(comp.release, name(BandParam::Release));
+            floatHelper(comp.threshold, name(BandParam::Threshold));
+            choiceHelper(comp.ratio, name(BandParam::Ratio));
+            boolHelper(comp.bypassed, name(BandParam::Bypassed));
+            boolHelper(comp.mute, name(BandParam::Mute));
+            boolHelper(comp.solo, name(BandParam::Solo));
+            floatHelper(comp.knee, name(BandParam::Knee));
+            boolHelper(comp.sidechain, name(BandParam::Sidechain));
+            choiceHelper(comp.stereoLink, linkName);
+        }
+
+        juce::StringArray watchedIDs { linkName, lookaheadName, oversamplingName, qualityName, crossoverModeName };
+        for (size_t split = 0; split < numSplits; ++split)
+        {
+            floatHelper(crossoverParams[split], GetCrossoverParamName<NumBands>(split));
+            watchedIDs.add(GetCrossoverParamName<NumBands>(split));
+        }
+
+        for (auto param : AllBandParams)
+            for (size_t band = 0; band < NumBands; ++band)
+                watchedIDs.add(GetBandParamName<NumBands>(param, band));
+
+        for (auto param : LateBandParams)
+            for (size_t band = 0; band < NumBands; ++band)
+                watchedIDs.add(GetBandParamName<NumBands>(param, band));
+
+        for (size_t band = 0; band < NumBands; ++band)
+            watchedIDs.add(GetBandParamName<NumBands>(BandParam::Sidechain, band));
+
+        parameterChanges.attach(apvts, watchedIDs);
+    }
+
+    /** Channels of the key passed to process(), 0 for no sidechain. Call before prepare(). */
+    void setSidechainChannels (size_t numChannels)
+    {
+        numKeyChannels = numChannels;
+
+        for (auto& compressor : compressors)
+        {
+            compressor.setSidechainChannels(numChannels);
+        }
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+        maximumBlockSize = static_cast<int>(spec.maximumBlockSize);
+        numMainChannels = spec.numChannels;
+
+        for (auto& compressor : compressors)
+        {
+            compressor.prepare(spec);
+        }
+
+        // The key is split by the same crossover as extra channels after the
+        // main ones, so it fills otherwise idle SIMD lanes and shares the
+        // coefficients, the sweep and the band buffers.
+        auto splitSpec = spec;
+        splitSpec.numChannels += static_cast<juce::uint32>(numKeyChannels);
+        splitChannels.resize(splitSpec.numChannels);
+
+        // Built once per sample rate; every split of the crossover reads from it.
+        crossoverTable.build(spec.sampleRate);
+        crossover.prepare(splitSpec, crossoverTable);
+
+        // Designs the linear-phase kernels for the current cutoffs before returning,
+        // so the first block already has them.
+        linearPhaseCrossover.prepare(splitSpec, readCrossoverFrequencies());
+
+        for (auto& buffer : filterBuffers)
+        {
+            buffer.setSize(static_cast<int>(splitSpec.numChannels), juce::jmax(static_cast<int>(spec.maximumBlockSize), 1));
+        }
+
+        // The crossover picks up new coefficients for the new sample rate on the
+        // next update, which jumps straight to the parameters rather than ramping.
+        parameterChanges.markDirty();
+        hasParameters = false;
+        silentSamples = 0;
+    }
+
+    /** Where process() adds the time spent in each stage; nullptr for nowhere.
+        Only used when built with SIMPLEMBCOMP_PROFILE=1.
+    */
+    void setStageProfile (Profiling::StageProfile<NumBands>* profileToUse) noexcept
+    {
+        profile = profileToUse;
+    }
+
+    /** For values that changed without notifying the parameters' listeners,
+        e.g. a SnapshotMorph's: the next updateParameters() re-reads them all.
+    */
+    void markParametersDirty() noexcept
+    {
+        parameterChanges.markDirty();
+    }
+
+    void setCrossoverSweepMode (CrossoverSweepMode mode)
+    {
+        crossover.setSweepMode(mode);
+    }
+
+    void setUseReferenceGainMath (bool shouldUseReference) noexcept
+    {
+        for (auto& compressor : compressors)
+        {
+            compressor.setUseReferenceGainMath(shouldUseReference);
+        }
+    }
+
+    /** Which channels the link setting ties together, e.g. from getChannelLinkGroups().
+        Call before prepare().
+    */
+    void setChannelGroups (const std::vector<int>& groups)
+    {
+        for (auto& compressor : compressors)
+        {
+            compressor.setChannelGroups(groups);
+        }
+    }
+
+    /** A block size to prepare with so that blocks are processed in tiles
+        small enough to stay in L1 from the crossover through the compressors
+        to the summation: a power of two from 32 to 128 samples, the largest
+        for which every band of every channel (key channels included) fits
+        in 16 kB.
+    */
+    static size_t getTileSize (size_t numChannels) noexcept
+    {
+        constexpr size_t workingSetBytes = 16 * 1024;
+        size_t tileSize = 128;
+
+        while (tileSize > 32 && juce::jmax<size_t>(1, numChannels) * NumBands * tileSize * sizeof(SampleType) > workingSetBytes)
+            tileSize /= 2;
+
+        return tileSize;
+    }
+
+    /** The largest block process() accepts. Bigger host blocks have to be split by the caller. */
+    size_t getMaximumBlockSize() const noexcept
+    {
+        return static_cast<size_t>(filterBuffers[0].getNumSamples());
+    }
+
+    size_t getNumChannels() const noexcept
+    {
+        return numMainChannels;
+    }
+
+    size_t getNumSidechainChannels() const noexcept
+    {
+        return numKeyChannels;
+    }
+
+    /** The lookahead delay at the prepared sample rate. Reads the parameter, so it
+        is already up to date before updateParameters() passes it to the compressors.
+    */
+    int getLookaheadSamples (const ParameterReader& read = {}) const noexcept
+    {
+        const auto samples = juce::roundToInt(read(*lookaheadParam) * 0.001 * sampleRate);
+        return juce::jlimit(0, LinkedCompressor<SampleType>::getMaxLookaheadSamples(sampleRate), samples);
+    }
+
+    size_t getOversamplingOrder (const ParameterReader& read = {}) const noexcept
+    {
+        return static_cast<size_t>(juce::jlimit(0, static_cast<int>(CompressorBand<SampleType>::maxOversamplingOrder), read(*oversamplingParam)));
+    }
+
+    OversamplingQuality getOversamplingQuality (const ParameterReader& read = {}) const noexcept
+    {
+        return static_cast<OversamplingQuality>(juce::jlimit(0, static_cast<int>(CompressorBand<SampleType>::numOversamplingQualities) - 1,
+                                                             read(*oversamplingQualityParam)));
+    }
+
+    bool isLinearPhase (const ParameterReader& read = {}) const noexcept
+    {
+        return read(*crossoverModeParam) == 1;
+    }
+
+    /** Message thread. The linear-phase kernel designer runs only while this
+        engine is the one in use and the linear-phase crossover is selected.
+    */
+    void updateLinearPhaseDesigner (bool engineIsInUse)
+    {
+        linearPhaseCrossover.setDesignerActive(engineIsInUse && isLinearPhase());
+    }
+
+    /** Lookahead, resampling filters and the linear-phase crossover, from the current parameter values. */
+    int getLatencySamples() const
+    {
+        return getLookaheadSamples()
+             + compressors[0].getOversamplingLatency(getOversamplingOrder(), getOversamplingQuality())
+             + (isLinearPhase() ? LinearPhaseCrossover<SampleType, NumBands>::getLatencySamples(sampleRate, maximumBlockSize) : 0);
+    }
+
+    /** How long the output keeps going after the input stops: the latency plus
+        the crossover's ring-out.
+    */
+    double getTailLengthSeconds() const
+    {
+        const auto latencySeconds = static_cast<double>(getLatencySamples()) / sampleRate;
+
+        // The linear-phase kernels reach half their length past the latency.
+        if ( isLinearPhase() )
+            return latencySeconds + static_cast<double>(LinearPhaseCrossover<SampleType, NumBands>::getKernelLength(sampleRate) / 2) / sampleRate;
+
+        auto lowestCutoff = static_cast<double>(crossoverParams[0]->get());
+        for (auto* param : crossoverParams)
+            lowestCutoff = juce::jmin(lowestCutoff, static_cast<double>(param->get()));
+
+        // The slowest poles are the lowest split's Butterworth pair, with a time
+        // constant of sqrt(2) / (2 pi fc). Count the ring-out as the time it
+        // takes them to decay by 120 dB.
+        const auto timeConstant = juce::MathConstants<double>::sqrt2 / (juce::MathConstants<double>::twoPi * lowestCutoff);
+        return latencySeconds + std::log(1.0e6) * timeConstant;
+    }
+
+    /** At most this many ramp steps per host block, each at least minRampStepSamples long. */
+    static constexpr int maxRampSteps = 16;
+    static constexpr size_t minRampStepSamples = 32;
+
+    /** Reads the parameters if any of them changed since the last call.
+        Call once per host block, before process(). When nothing changed this is
+        a single atomic exchange.
+
+        Automation only reaches the plugin once per host block, so a change is
+        spread over the block instead of landing on its first sample: the
+        thresholds, knees, attacks, releases and crossover frequencies move
+        to their new values in equal steps. Returns the number of steps,
+        1 when nothing has to ramp. The block has to be processed as that
+        many equal segments (sample i of numSamplesInBlock is in segment
+        i * numSteps / numSamplesInBlock) with advanceParameters() called
+        before each one after the first; the last segment gets exactly the
+        new values. Switches, choices and the lookahead change at once.
+
+        In Smoothed crossover mode the crossovers are not stepped: they get
+        the new cutoffs at the start of the block and glide there on their
+        own over LinkwitzRileyCrossover::sweepTimeSeconds, so they arrive up
+        to that much later than a stepped ramp would.
+
+        The parameters are read through read, which a preset morph uses to
+        substitute its own values.
+    */
+    int updateParameters (size_t numSamplesInBlock, const ParameterReader& read = {})
+    {
+        if ( ! parameterChanges.checkAndClear() )
+            return 1;
+
+        // The first read after prepare() has nothing to ramp from.
+        const auto numSteps = hasParameters ? juce::jlimit(1, maxRampSteps, static_cast<int>(numSamplesInBlock / minRampStepSamples))
+                                            : 1;
+        hasParameters = true;
+
+        const auto lookahead = getLookaheadSamples(read);
+        const auto oversamplingOrder = getOversamplingOrder(read);
+        const auto oversamplingQuality = getOversamplingQuality(read);
+        auto ramping = false;
+
+        for (auto& compressor : compressors)
+        {
+            ramping = compressor.rampToSettings(compressor.readSettings(read), numSteps) || ramping;
+            compressor.setOversampling(oversamplingOrder, oversamplingQuality);
+            compressor.setLookahead(lookahead);
+        }
+
+        // Whichever crossover takes over starts from silence rather than stale state.
+        const auto linearPhase = isLinearPhase(read);
+        if ( linearPhase != useLinearPhase )
+        {
+            useLinearPhase = linearPhase;
+
+            if ( useLinearPhase )
+                linearPhaseCrossover.reset();
+            else
+                crossover.reset();
+        }
+
+        // The linear-phase kernels are designed off the audio thread, so they
+        // only get the final cutoffs, and only while they are in use. Switching
+        // to linear phase asks for the current cutoffs once if they moved since.
+        const auto cutoffs = readCrossoverFrequencies(read);
+        if ( useLinearPhase )
+            linearPhaseCrossover.setCrossoverFrequencies(cutoffs);
+
+        // Restarting the crossover's own glide at every step would only slow it down.
+        const auto stepCrossovers = numSteps > 1 && crossover.getSweepMode() == CrossoverSweepMode::Stepped;
+
+        for (size_t split = 0; split < numSplits; ++split)
+        {
+            auto& ramp = cutoffRamps[split];
+            if ( stepCrossovers )
+            {
+                ramp.reset(numSteps);
+                ramp.setTargetValue(cutoffs[split]);
+                ramping = ramping || ramp.isSmoothing();
+            }
+            else
+            {
+                ramp.setCurrentAndTargetValue(cutoffs[split]);
+            }
+        }
+
+        stepCrossoverRamp();
+
+        // Whatever changed may have to ring out before skipping is safe again.
+        silenceHoldSamples = getSilenceHoldSamples();
+        silentSamples = 0;
+
+        return ramping ? numSteps : 1;
+    }
+
+    /** The next step of the ramp started by updateParameters(). Only touches
+        what is still moving, and the coefficients that depend on it.
+    */
+    void advanceParameters()
+    {
+        for (auto& compressor : compressors)
+            compressor.stepRamp();
+
+        stepCrossoverRamp();
+    }
+
+    /** Splits, compresses and re-sums block in place.
+        If workers is not null the compressors run on it in parallel.
+        If meters is not null every band's input and output levels are added to it.
+        key is the sidechain, or empty for none. It is only split when a band
+        listens to it, and then overwritten with its lowest band.
+
+        Bands that can't be heard (muted, or another band is soloed) are split
+        and tracked but not compressed: their resampling filters, lookahead
+        delay and envelopes keep running, so they come back in without a
+        glitch, but no gain is computed. Once the input has been digitally
+        silent for longer than every filter, delay and envelope takes to
+        settle, nothing runs at all and the silent block is passed through.
+    */
+    void process (juce::dsp::AudioBlock<SampleType> block, BandWorkerPool* workers, MeterFrame<NumBands>* meters = nullptr,
+                  juce::dsp::AudioBlock<SampleType> key = {})
+    {
+        auto numSamples = block.getNumSamples();
+        auto numChannels = block.getNumChannels();
+
+        jassert(numSamples <= getMaximumBlockSize());
+        jassert(numChannels <= getNumChannels());
+
+        const auto anyBandKeyed = std::any_of(compressors.begin(), compressors.end(),
+                                              [](const auto& comp) { return comp.getSettings().keyed; });
+        const auto numKeys = anyBandKeyed ? juce::jmin(key.getNumChannels(), numKeyChannels) : size_t(0);
+        jassert(numKeys == 0 || key.getNumSamples() == numSamples);
+
+        // A key the detectors listen to has to be silent too, or their envelopes would go stale.
+        if ( isSilent(block) && (numKeys == 0 || isSilent(key.getSubsetChannelBlock(0, numKeys))) )
+        {
+            const auto settled = silentSamples >= silenceHoldSamples;
+            silentSamples = static_cast<int>(juce::jmin(static_cast<size_t>(silenceHoldSamples), static_cast<size_t>(silentSamples) + numSamples));
+
+            if ( settled )
+                return;
+        }
+        else
+        {
+            silentSamples = 0;
+        }
+
+        // The lowest band is split in place into the host buffer (and the key's
+        // channels), the others go straight into the filterBuffers. Nothing is copied.
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            splitChannels[ch] = block.getChannelPointer(ch);
+        for (size_t ch = 0; ch < numKeys; ++ch)
+            splitChannels[numChannels + ch] = key.getChannelPointer(ch);
+
+        const auto numSplitChannels = numChannels + numKeys;
+        typename LinkwitzRileyCrossover<SampleType, NumBands>::BandBlocks splitBlocks;
+        splitBlocks[0] = juce::dsp::AudioBlock<SampleType>(splitChannels.data(), numSplitChannels, numSamples);
+        for (size_t i = 1; i < NumBands; ++i)
+        {
+            splitBlocks[i] = juce::dsp::AudioBlock<SampleType>(filterBuffers[i - 1])
+                                 .getSubsetChannelBlock(0, numSplitChannels)
+                                 .getSubBlock(0, numSamples);
+        }
+
+        {
+            ScopedStage timer (profile, Profiling::crossover);
+
+            if ( useLinearPhase )
+                linearPhaseCrossover.process(splitBlocks[0], splitBlocks);
+            else
+                crossover.process(splitBlocks[0], splitBlocks);
+        }
+
+        typename LinkwitzRileyCrossover<SampleType, NumBands>::BandBlocks bandBlocks;
+        std::array<juce::dsp::AudioBlock<const SampleType>, NumBands> keyBlocks;
+        for (size_t i = 0; i < NumBands; ++i)
+        {
+            bandBlocks[i] = splitBlocks[i].getSubsetChannelBlock(0, numChannels);
+
+            if ( numKeys > 0 && compressors[i].getSettings().keyed )
+                keyBlocks[i] = splitBlocks[i].getSubsetChannelBlock(numChannels, numKeys);
+        }
+
+        auto meterInput = [meters](size_t i, const juce::dsp::AudioBlock<SampleType>& bandBlock)
+        {
+            if ( meters != nullptr )
+                meters->bandInput[i].add(bandBlock);
+        };
+
+        auto meterOutput = [meters](size_t i, const juce::dsp::AudioBlock<SampleType>& bandBlock)
+        {
+            if ( meters != nullptr )
+                meters->bandOutput[i].add(bandBlock);
+        };
+
+        auto bandsAreSoloed = false;
+        for ( auto& comp : compressors )
+        {
+            if ( comp.getSettings().solo )
+            {
+                bandsAreSoloed = true;
+                break;
+            }
+        }
+
+        std::array<bool, NumBands> bandIsAudible;
+        for ( size_t i = 0; i < NumBands; ++i)
+        {
+            const auto& settings = compressors[i].getSettings();
+            bandIsAudible[i] = bandsAreSoloed ? settings.solo : ! settings.mute;
+        }
+
+        auto hostBlockHoldsOutput = bandIsAudible[0];
+
+        if ( workers != nullptr )
+        {
+            // Each task only touches its own band's meters.
+            auto compressBand = [this, &bandBlocks, &keyBlocks, &bandIsAudible, &meterInput, &meterOutput](size_t i)
+            {
+                meterInput(i, bandBlocks[i]);
+
+                if ( ! bandIsAudible[i] )
+                {
+                    compressors[i].track(bandBlocks[i], keyBlocks[i]);
+                    return;
+                }
+
+                {
+                    ScopedStage timer (profile, bandStage(i));
+                    compressors[i].process(bandBlocks[i], keyBlocks[i]);
+                }
+
+                meterOutput(i, bandBlocks[i]);
+            };
+
+            workers->run(NumBands, compressBand);
+
+            ScopedStage timer (profile, Profiling::summation);
+
+            for ( size_t i = 1; i < NumBands; ++i)
+            {
+                if ( ! bandIsAudible[i] )
+                    continue;
+
+                if ( hostBlockHoldsOutput )
+                    block.add(bandBlocks[i]);
+                else
+                    block.copyFrom(bandBlocks[i]);
+
+                hostBlockHoldsOutput = true;
+            }
+        }
+        else
+        {
+            // Each band is summed into the host buffer as soon as its compressor is
+            // done. The host buffer already holds the lowest band, so the first
+            // audible band after a silent lowest band is compressed straight into it.
+            for ( size_t i = 0; i < NumBands; ++i)
+            {
+                meterInput(i, bandBlocks[i]);
+            }
+
+            if ( bandIsAudible[0] )
+            {
+                {
+                    ScopedStage timer (profile, bandStage(0));
+                    compressors[0].process(bandBlocks[0], keyBlocks[0]);
+                }
+
+                meterOutput(0, bandBlocks[0]);
+            }
+            else
+            {
+                compressors[0].track(bandBlocks[0], keyBlocks[0]);
+            }
+
+            for ( size_t i = 1; i < NumBands; ++i)
+            {
+                if ( ! bandIsAudible[i] )
+                {
+                    compressors[i].track(bandBlocks[i], keyBlocks[i]);
+                    continue;
+                }
+
+                // Compressing into the host buffer also does the band's summation.
+                if ( ! hostBlockHoldsOutput )
+                {
+                    {
+                        ScopedStage timer (profile, bandStage(i));
+                        compressors[i].process(bandBlocks[i], block, keyBlocks[i]);
+                    }
+
+                    meterOutput(i, block);
+                    hostBlockHoldsOutput = true;
+                    continue;
+                }
+
+                {
+                    ScopedStage timer (profile, bandStage(i));
+                    compressors[i].process(bandBlocks[i], keyBlocks[i]);
+                }
+
+                meterOutput(i, bandBlocks[i]);
+
+                ScopedStage timer (profile, Profiling::summation);
+                block.add(bandBlocks[i]);
+            }
+        }
+
+        if ( ! hostBlockHoldsOutput )
+        {
+            ScopedStage timer (profile, Profiling::summation);
+            block.clear();
+        }
+    }
+
+private:
+    using ScopedStage = typename Profiling::StageProfile<NumBands>::ScopedStage;
+
+    static constexpr int bandStage (size_t band) noexcept
+    {
+        return Profiling::firstBand + static_cast<int>(band);
+    }
+
+    template <typename BlockSampleType>
+    static bool isSilent (const juce::dsp::AudioBlock<BlockSampleType>& block) noexcept
+    {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+        {
+            const auto* data = block.getChannelPointer(ch);
+            for (size_t i = 0; i < block.getNumSamples(); ++i)
+                if ( data[i] != SampleType(0) )
+                    return false;
+        }
+
+        return true;
+    }
+
+    /** How long the input has to stay silent before processing can stop:
+        the output's tail, plus the slowest release bringing its envelope
+        down by 120 dB so that nothing is left to carry into the next sound.
+    */
+    int getSilenceHoldSamples() const
+    {
+        auto slowestRelease = 0.f;
+        for (auto& compressor : compressors)
+            slowestRelease = juce::jmax(slowestRelease, compressor.getSettings().release, compressor.getTargetSettings().release);
+
+        const auto releaseTimeConstant = slowestRelease * 0.001 / juce::MathConstants<double>::twoPi;
+        const auto seconds = getTailLengthSeconds() + std::log(1.0e6) * releaseTimeConstant;
+        return static_cast<int>(std::ceil(seconds * sampleRate));
+    }
+
+    // Multiplicative, so the cutoffs move in equal steps of log frequency.
+    void stepCrossoverRamp()
+    {
+        std::array<SampleType, numSplits> cutoffs;
+        for (size_t split = 0; split < numSplits; ++split)
+            cutoffs[split] = cutoffRamps[split].getNextValue();
+
+        crossover.setCrossoverFrequencies(cutoffs);
+    }
+
+    std::array<SampleType, numSplits> readCrossoverFrequencies (const ParameterReader& read = {}) const
+    {
+        std::array<SampleType, numSplits> cutoffs;
+        for (size_t split = 0; split < numSplits; ++split)
+        {
+            cutoffs[split] = read(*crossoverParams[split]);
+        }
+
+        return cutoffs;
+    }
+
+    std::array<CompressorBand<SampleType>, NumBands> compressors;
+    std::array<juce::AudioParameterFloat*, numSplits> crossoverParams {};
+    juce::AudioParameterFloat* lookaheadParam { nullptr };
+    juce::AudioParameterChoice* oversamplingParam { nullptr };
+    juce::AudioParameterChoice* oversamplingQualityParam { nullptr };
+    juce::AudioParameterChoice* crossoverModeParam { nullptr };
+    double sampleRate = 44100.0;
+    int maximumBlockSize = 512;
+    size_t numMainChannels = 0, numKeyChannels = 0;
+    ParameterChangeFlag parameterChanges;
+    bool hasParameters = false;
+    std::array<juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative>, numSplits> cutoffRamps;
+
+    CrossoverCoefficientTable<SampleType> crossoverTable;
+    LinkwitzRileyCrossover<SampleType, NumBands> crossover;
+    LinearPhaseCrossover<SampleType, NumBands> linearPhaseCrossover;
+    bool useLinearPhase = false;
+
+    // Storage for every band but the lowest, which is split in place into the host buffer.
+    // The key's bands follow the main channels.
+    std::array<juce::AudioBuffer<SampleType>, numSplits> filterBuffers;
+    std::vector<SampleType*> splitChannels;
+
+    Profiling::StageProfile<NumBands>* profile { nullptr };
+    int silentSamples = 0, silenceHoldSamples = 0;
+};
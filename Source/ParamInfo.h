@@ -15,81 +15,138 @@ namespace Params
 {
     enum Names
     {
-        Low_Mid_Crossover_Freq,
-        Mid_High_Crossover_Freq,
-        
-        Threshold_Low_Band,
-        Threshold_Mid_Band,
-        Threshold_High_Band,
-        
-        Attack_Low_Band,
-        Attack_Mid_Band,
-        Attack_High_Band,
-        
-        Release_Low_Band,
-        Release_Mid_Band,
-        Release_High_Band,
-        
-        Ratio_Low_Band,
-        Ratio_Mid_Band,
-        Ratio_High_Band,
-        
-        Bypassed_Low_Band,
-        Bypassed_Mid_Band,
-        Bypassed_High_Band,
-        
-        Mute_Low_Band,
-        Mute_Mid_Band,
-        Mute_High_Band,
-        
-        Solo_Low_Band,
-        Solo_Mid_Band,
-        Solo_High_Band,
-        
         Gain_In,
         Gain_Out,
+        Stereo_Link,
+        Lookahead,
+        Oversampling,
+        Oversampling_Quality,
+        Crossover_Mode,
     };
-    
+
     inline const std::map<Names, juce::String>& GetParams()
     {
         static std::map<Names, juce::String> params =
         {
-            {Low_Mid_Crossover_Freq, "Low-Mid Crossover Freq"},
-            {Mid_High_Crossover_Freq,"Mid-High Crossover Freq"},
-            
-            {Threshold_Low_Band,"Threshold Low Band"},
-            {Threshold_Mid_Band,"Threshold Mid Band"},
-            {Threshold_High_Band,"Threshold High Band"},
-            
-            {Attack_Low_Band,"Attack Low Band"},
-            {Attack_Mid_Band,"Attack Mid Band"},
-            {Attack_High_Band,"Attack High Band"},
-            
-            {Release_Low_Band,"Release Low Band"},
-            {Release_Mid_Band,"Release Mid Band"},
-            {Release_High_Band,"Release High Band"},
-            
-            {Ratio_Low_Band,"Ratio Low Band"},
-            {Ratio_Mid_Band,"Ratio Mid Band"},
-            {Ratio_High_Band,"Ratio High Band"},
-            
-            {Bypassed_Low_Band,"Bypassed Low Band"},
-            {Bypassed_Mid_Band,"Bypassed Mid Band"},
-            {Bypassed_High_Band,"Bypassed High Band"},
-            
-            {Mute_Low_Band, "Mute Low Band"},
-            {Mute_Mid_Band, "Mute Mid Band"},
-            {Mute_High_Band, "Mute High Band"},
-            
-            {Solo_Low_Band, "Solo Low Band"},
-            {Solo_Mid_Band, "Solo Mid Band"},
-            {Solo_High_Band, "Solo High Band"},
-            
             {Gain_In, "Gain In"},
             {Gain_Out, "Gain Out"},
+            {Stereo_Link, "Stereo Link"},
+            {Lookahead, "Lookahead"},
+            {Oversampling, "Oversampling"},
+            {Oversampling_Quality, "Oversampling Quality"},
+            {Crossover_Mode, "Crossover Mode"},
         };
-        
+
         return params;
     }
-}
 
+    //==============================================================================
+    // Per-band and crossover parameters are generated from the band count, so
+    // every MultibandCompressor<N> gets its own table. The three band names
+    // match the original hand written IDs, which keeps old sessions loading.
+    enum class BandParam
+    {
+        Threshold,
+        Attack,
+        Release,
+        Ratio,
+        Bypassed,
+        Mute,
+        Solo,
+        Knee,
+        Sidechain,
+    };
+
+    constexpr std::array<BandParam, 7> AllBandParams
+    {
+        BandParam::Threshold,
+        BandParam::Attack,
+        BandParam::Release,
+        BandParam::Ratio,
+        BandParam::Bypassed,
+        BandParam::Mute,
+        BandParam::Solo,
+    };
+
+    // Per-band parameters added after the global ones, so that the parameters
+    // above keep their indices in hosts that address them by index.
+    constexpr std::array<BandParam, 1> LateBandParams
+    {
+        BandParam::Knee,
+    };
+
+    constexpr const char* GetBandParamPrefix (BandParam param)
+    {
+        switch (param)
+        {
+            case BandParam::Threshold: return "Threshold";
+            case BandParam::Attack:    return "Attack";
+            case BandParam::Release:   return "Release";
+            case BandParam::Ratio:     return "Ratio";
+            case BandParam::Bypassed:  return "Bypassed";
+            case BandParam::Mute:      return "Mute";
+            case BandParam::Solo:      return "Solo";
+            case BandParam::Knee:      return "Knee";
+            case BandParam::Sidechain: return "Sidechain";
+        }
+
+        return "";
+    }
+
+    // The ratio parameter's choices. The compressors index this directly
+    // instead of parsing the choice name back into a number.
+    constexpr std::array<float, 10> RatioChoices { 1.f, 2.f, 3.f, 5.f, 8.f, 13.f, 21.f, 34.f, 55.f, 89.f };
+
+    template <size_t NumBands>
+    constexpr std::array<const char*, NumBands> GetBandNames()
+    {
+        static_assert(NumBands >= 2 && NumBands <= 6, "Add band names for this band count");
+
+        if constexpr (NumBands == 2)
+            return { "Low", "High" };
+        else if constexpr (NumBands == 3)
+            return { "Low", "Mid", "High" };
+        else if constexpr (NumBands == 4)
+            return { "Low", "Low Mid", "High Mid", "High" };
+        else if constexpr (NumBands == 5)
+            return { "Low", "Low Mid", "Mid", "High Mid", "High" };
+        else
+            return { "Sub", "Low", "Low Mid", "High Mid", "Presence", "Air" };
+    }
+
+    template <size_t NumBands>
+    juce::String GetBandParamName (BandParam param, size_t band)
+    {
+        return juce::String(GetBandParamPrefix(param)) + " " + GetBandNames<NumBands>()[band] + " Band";
+    }
+
+    template <size_t NumBands>
+    juce::String GetCrossoverParamName (size_t split)
+    {
+        const auto names = GetBandNames<NumBands>();
+        return juce::String(names[split]) + "-" + names[split + 1] + " Crossover Freq";
+    }
+
+    struct CrossoverRange
+    {
+        float minimum, maximum, defaultValue;
+    };
+
+    template <size_t NumBands>
+    CrossoverRange GetCrossoverRange (size_t split)
+    {
+        if constexpr (NumBands == 3)
+        {
+            return split == 0 ? CrossoverRange { 20.f, 999.f, 500.f }
+                              : CrossoverRange { 1000.f, 20000.f, 3000.f };
+        }
+        else
+        {
+            // Equal slices of 20 Hz - 20 kHz on a log scale, default in the middle of each.
+            auto edge = [](float position) { return 20.f * std::pow(1000.f, position / static_cast<float>(NumBands - 1)); };
+            auto low = std::round(edge(static_cast<float>(split)));
+            auto high = std::round(edge(static_cast<float>(split + 1)));
+            return { low, split + 2 < NumBands ? high - 1.f : high, std::round(std::sqrt(low * high)) };
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    ParameterChangeFlag.h
+    Created: 17 Oct 2026 3:57:24am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Watches a set of APVTS parameters and raises an atomic flag whenever one
+    of them changes, from whichever thread changed it. The audio thread polls
+    the flag once per block and only re-reads its parameters, and recomputes
+    whatever depends on them, when it was set.
+*/
+class ParameterChangeFlag : private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    ParameterChangeFlag() = default;
+
+    ~ParameterChangeFlag() override
+    {
+        detach();
+    }
+
+    void attach (juce::AudioProcessorValueTreeState& apvts, const juce::StringArray& parameterIDs)
+    {
+        detach();
+
+        state = &apvts;
+        watchedIDs = parameterIDs;
+
+        for (auto& id : watchedIDs)
+            state->addParameterListener(id, this);
+
+        markDirty();
+    }
+
+    void detach()
+    {
+        if (state == nullptr)
+            return;
+
+        for (auto& id : watchedIDs)
+            state->removeParameterListener(id, this);
+
+        state = nullptr;
+        watchedIDs.clear();
+    }
+
+    void markDirty() noexcept
+    {
+        dirty.store(true, std::memory_order_release);
+    }
+
+    /** True if anything changed since the last call. Clears the flag. */
+    bool checkAndClear() noexcept
+    {
+        return dirty.exchange(false, std::memory_order_acq_rel);
+    }
+
+private:
+    void parameterChanged (const juce::String&, float) override
+    {
+        markDirty();
+    }
+
+    juce::AudioProcessorValueTreeState* state = nullptr;
+    juce::StringArray watchedIDs;
+    std::atomic<bool> dirty { true };
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterChangeFlag)
+};
@@ -9,17 +9,308 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+void LevelMeter::setLevels (float peakDecibels, float rmsDecibels, float fallDecibels)
+{
+    auto follow = [fallDecibels](float current, float target)
+    {
+        return juce::jlimit(minDecibels, maxDecibels, juce::jmax(target, current - fallDecibels));
+    };
+
+    auto newPeak = follow(peak, peakDecibels);
+    auto newRms = follow(rms, rmsDecibels);
+
+    if ( newPeak != peak || newRms != rms )
+    {
+        peak = newPeak;
+        rms = newRms;
+        repaint();
+    }
+}
+
+void LevelMeter::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black);
+    g.fillRect(bounds);
+
+    auto levelToY = [&bounds](float decibels)
+    {
+        return juce::jmap(decibels, minDecibels, maxDecibels, bounds.getBottom(), bounds.getY());
+    };
+
+    g.setColour(rms > 0.f ? juce::Colours::red : juce::Colours::limegreen);
+    g.fillRect(bounds.withTop(levelToY(rms)));
+
+    g.setColour(juce::Colours::white);
+    g.fillRect(bounds.withTop(levelToY(peak)).withHeight(2.f));
+
+    g.setColour(juce::Colours::grey);
+    g.drawHorizontalLine(juce::roundToInt(levelToY(0.f)), bounds.getX(), bounds.getRight());
+}
+
+//==============================================================================
+void GainReductionMeter::setGainReduction (float decibels, float releaseDecibels)
+{
+    auto newReduction = juce::jlimit(maxReductionDecibels, 0.f, juce::jmin(decibels, reduction + releaseDecibels));
+
+    if ( newReduction != reduction )
+    {
+        reduction = newReduction;
+        repaint();
+    }
+}
+
+void GainReductionMeter::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colours::black);
+    g.fillRect(bounds);
+
+    auto height = juce::jmap(reduction, 0.f, maxReductionDecibels, 0.f, bounds.getHeight());
+    g.setColour(juce::Colours::orange);
+    g.fillRect(bounds.withHeight(height));
+}
+
+//==============================================================================
+SpectrumDisplay::SpectrumDisplay (SimpleMBCompAudioProcessor& processor)
+    : analyzer({ &processor.getAnalyzerInput(), &processor.getAnalyzerOutput() },
+               [&processor] { return processor.getAnalyzerSampleRate(); })
+{
+    using MultibandComp = SimpleMBCompAudioProcessor::MultibandComp;
+
+    for (size_t split = 0; split < MultibandComp::numSplits; ++split)
+        crossoverParams.push_back(processor.apvts.getParameter(Params::GetCrossoverParamName<MultibandComp::numBands>(split)));
+}
+
+void SpectrumDisplay::update()
+{
+    if ( analyzer.getPaths(paths) )
+        repaint();
+}
+
+juce::Rectangle<float> SpectrumDisplay::getPlotArea() const
+{
+    return getLocalBounds().toFloat().reduced(1.f);
+}
+
+void SpectrumDisplay::resized()
+{
+    analyzer.setBounds(getPlotArea());
+}
+
+void SpectrumDisplay::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    auto area = getPlotArea();
+    g.setColour(juce::Colours::black);
+    g.fillRect(bounds);
+
+    g.setColour(juce::Colours::darkgrey);
+    for ( auto frequency : { 50.f, 100.f, 200.f, 500.f, 1000.f, 2000.f, 5000.f, 10000.f } )
+        g.drawVerticalLine(juce::roundToInt(SpectrumAnalyzer::frequencyToX(frequency, area)), area.getY(), area.getBottom());
+
+    for ( auto decibels = -72.f; decibels <= 0.f; decibels += 12.f )
+        g.drawHorizontalLine(juce::roundToInt(SpectrumAnalyzer::decibelsToY(decibels, area)), area.getX(), area.getRight());
+
+    // Input filled underneath, output as a line on top.
+    if ( paths.size() == 2 && ! paths[0].isEmpty() )
+    {
+        auto input = paths[0];
+        input.lineTo(area.getRight(), area.getBottom());
+        input.lineTo(area.getX(), area.getBottom());
+        input.closeSubPath();
+
+        g.setColour(juce::Colours::skyblue.withAlpha(0.3f));
+        g.fillPath(input);
+    }
+
+    if ( paths.size() == 2 )
+    {
+        g.setColour(juce::Colours::orange);
+        g.strokePath(paths[1], juce::PathStrokeType(1.5f));
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.7f));
+    for ( auto* param : crossoverParams )
+    {
+        if ( param == nullptr )
+            continue;
+
+        auto frequency = param->convertFrom0to1(param->getValue());
+        g.drawVerticalLine(juce::roundToInt(SpectrumAnalyzer::frequencyToX(frequency, area)), area.getY(), area.getBottom());
+    }
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(bounds);
+}
+
+//==============================================================================
+LabelledSlider::LabelledSlider (juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, const juce::String& labelText)
+    : slider(juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow),
+      label({}, labelText),
+      attachment(apvts, paramID, slider)
+{
+    slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 16);
+    label.setJustificationType(juce::Justification::centred);
+    label.setFont(12.f);
+
+    addAndMakeVisible(slider);
+    addAndMakeVisible(label);
+}
+
+void LabelledSlider::resized()
+{
+    auto bounds = getLocalBounds();
+    label.setBounds(bounds.removeFromBottom(14));
+    slider.setBounds(bounds);
+}
+
+//==============================================================================
+namespace
+{
+    juce::String bandParamID (Params::BandParam param, size_t band)
+    {
+        return Params::GetBandParamName<SimpleMBCompAudioProcessor::numBands>(param, band);
+    }
+}
+
+BandControls::BandControls (juce::AudioProcessorValueTreeState& apvts, size_t band)
+    : name({}, Params::GetBandNames<SimpleMBCompAudioProcessor::numBands>()[band]),
+      threshold(apvts, bandParamID(Params::BandParam::Threshold, band), "Threshold"),
+      knee(apvts, bandParamID(Params::BandParam::Knee, band), "Knee"),
+      attack(apvts, bandParamID(Params::BandParam::Attack, band), "Attack"),
+      release(apvts, bandParamID(Params::BandParam::Release, band), "Release"),
+      ratioAttachment(apvts, bandParamID(Params::BandParam::Ratio, band), ratio),
+      bypassAttachment(apvts, bandParamID(Params::BandParam::Bypassed, band), bypass),
+      muteAttachment(apvts, bandParamID(Params::BandParam::Mute, band), mute),
+      soloAttachment(apvts, bandParamID(Params::BandParam::Solo, band), solo),
+      sidechainAttachment(apvts, bandParamID(Params::BandParam::Sidechain, band), sidechain)
+{
+    name.setJustificationType(juce::Justification::centred);
+
+    // The ComboBoxAttachment needs the items before it can show the current choice.
+    if ( auto* choice = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(bandParamID(Params::BandParam::Ratio, band))) )
+    {
+        ratio.addItemList(choice->choices, 1);
+        ratio.setSelectedItemIndex(choice->getIndex(), juce::dontSendNotification);
+    }
+
+    for ( auto* button : { &bypass, &mute, &solo, &sidechain } )
+        button->setClickingTogglesState(true);
+
+    for ( auto* child : std::initializer_list<juce::Component*> { &name, &inputMeter, &gainReductionMeter, &outputMeter,
+                                                                 &threshold, &knee, &attack, &release, &ratio,
+                                                                 &bypass, &mute, &solo, &sidechain } )
+        addAndMakeVisible(child);
+}
+
+void BandControls::resized()
+{
+    auto bounds = getLocalBounds().reduced(4);
+
+    name.setBounds(bounds.removeFromTop(20));
+
+    auto meters = bounds.removeFromTop(120).reduced(bounds.getWidth() / 6, 4);
+    auto meterWidth = meters.getWidth() / 3;
+    inputMeter.setBounds(meters.removeFromLeft(meterWidth).reduced(2, 0));
+    outputMeter.setBounds(meters.removeFromRight(meterWidth).reduced(2, 0));
+    gainReductionMeter.setBounds(meters.reduced(2, 0));
+
+    auto level = bounds.removeFromTop(80);
+    threshold.setBounds(level.removeFromLeft(level.getWidth() / 2));
+    knee.setBounds(level);
+
+    auto timing = bounds.removeFromTop(80);
+    attack.setBounds(timing.removeFromLeft(timing.getWidth() / 2));
+    release.setBounds(timing);
+
+    ratio.setBounds(bounds.removeFromTop(28).reduced(0, 2));
+
+    auto buttons = bounds.removeFromTop(28).reduced(0, 2);
+    auto buttonWidth = buttons.getWidth() / 4;
+    bypass.setBounds(buttons.removeFromLeft(buttonWidth).reduced(2, 0));
+    mute.setBounds(buttons.removeFromLeft(buttonWidth).reduced(2, 0));
+    solo.setBounds(buttons.removeFromLeft(buttonWidth).reduced(2, 0));
+    sidechain.setBounds(buttons.reduced(2, 0));
+}
+
 //==============================================================================
 SimpleMBCompAudioProcessorEditor::SimpleMBCompAudioProcessorEditor (SimpleMBCompAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p),
+      inputGain (p.apvts, Params::GetParams().at(Params::Names::Gain_In), "Gain In"),
+      outputGain (p.apvts, Params::GetParams().at(Params::Names::Gain_Out), "Gain Out"),
+      lookahead (p.apvts, Params::GetParams().at(Params::Names::Lookahead), "Lookahead"),
+      stereoLinkAttachment (p.apvts, Params::GetParams().at(Params::Names::Stereo_Link), stereoLink),
+      crossoverModeAttachment (p.apvts, Params::GetParams().at(Params::Names::Crossover_Mode), crossoverMode),
+      oversamplingAttachment (p.apvts, Params::GetParams().at(Params::Names::Oversampling), oversampling),
+      oversamplingQualityAttachment (p.apvts, Params::GetParams().at(Params::Names::Oversampling_Quality), oversamplingQuality),
+      spectrum (p)
 {
+    using MultibandComp = SimpleMBCompAudioProcessor::MultibandComp;
+
+    for (size_t split = 0; split < MultibandComp::numSplits; ++split)
+    {
+        auto paramID = Params::GetCrossoverParamName<MultibandComp::numBands>(split);
+        addAndMakeVisible(crossovers.add(new LabelledSlider(p.apvts, paramID, paramID.upToLastOccurrenceOf(" Crossover", false, false))));
+    }
+
+    for (size_t band = 0; band < MultibandComp::numBands; ++band)
+        addAndMakeVisible(bands.add(new BandControls(p.apvts, band)));
+
+    auto fillChoices = [&p](juce::ComboBox& box, Params::Names name)
+    {
+        if ( auto* choice = dynamic_cast<juce::AudioParameterChoice*>(p.apvts.getParameter(Params::GetParams().at(name))) )
+        {
+            box.addItemList(choice->choices, 1);
+            box.setSelectedItemIndex(choice->getIndex(), juce::dontSendNotification);
+        }
+    };
+
+    fillChoices(stereoLink, Params::Names::Stereo_Link);
+    fillChoices(crossoverMode, Params::Names::Crossover_Mode);
+    fillChoices(oversampling, Params::Names::Oversampling);
+    fillChoices(oversamplingQuality, Params::Names::Oversampling_Quality);
+
+    for ( auto* label : { &stereoLinkLabel, &crossoverModeLabel, &oversamplingLabel } )
+    {
+        label->setJustificationType(juce::Justification::centred);
+        label->setFont(12.f);
+    }
+
+    // A/B compare: the two slots are exclusive, Copy overwrites the inactive one.
+    for ( auto* button : { &compareA, &compareB } )
+    {
+        button->setClickingTogglesState(false);
+        button->setRadioGroupId(1);
+    }
+
+    compareA.onClick = [this] { audioProcessor.getPresetManager().switchTo(PresetManager::Slot::A); updateCompareButtons(); };
+    compareB.onClick = [this] { audioProcessor.getPresetManager().switchTo(PresetManager::Slot::B); updateCompareButtons(); };
+    copyToOther.onClick = [this] { audioProcessor.getPresetManager().copyToOtherSlot(); };
+    updateCompareButtons();
+
+    for ( auto* child : std::initializer_list<juce::Component*> { &inputGain, &outputGain, &lookahead, &stereoLinkLabel, &stereoLink,
+                                                                 &crossoverModeLabel, &crossoverMode,
+                                                                 &oversamplingLabel, &oversampling, &oversamplingQuality,
+                                                                 &compareA, &compareB, &copyToOther,
+                                                                 &inputMeter, &outputMeter, &spectrum } )
+        addAndMakeVisible(child);
+
+    audioProcessor.setMeteringEnabled(true);
+    audioProcessor.setAnalyzerEnabled(true);
+    startTimerHz(meterRefreshRateHz);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (120 * static_cast<int>(MultibandComp::numBands) + 160, 620);
 }
 
 SimpleMBCompAudioProcessorEditor::~SimpleMBCompAudioProcessorEditor()
 {
+    stopTimer();
+    audioProcessor.setMeteringEnabled(false);
+    audioProcessor.setAnalyzerEnabled(false);
 }
 
 //==============================================================================
@@ -28,13 +319,75 @@ void SimpleMBCompAudioProcessorEditor::paint (juce::Graphics& g)
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
+    g.setColour (juce::Colours::grey);
+    for (auto* band : bands)
+        g.drawRect (band->getBounds());
 }
 
 void SimpleMBCompAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto bounds = getLocalBounds().reduced(4);
+
+    auto left = bounds.removeFromLeft(76);
+    stereoLinkLabel.setBounds(left.removeFromTop(16));
+    stereoLink.setBounds(left.removeFromTop(24));
+    crossoverModeLabel.setBounds(left.removeFromTop(16));
+    crossoverMode.setBounds(left.removeFromTop(24));
+    auto compareRow = left.removeFromTop(24).reduced(0, 2);
+    compareA.setBounds(compareRow.removeFromLeft(20));
+    compareB.setBounds(compareRow.removeFromLeft(20));
+    copyToOther.setBounds(compareRow.withTrimmedLeft(2));
+    inputGain.setBounds(left.removeFromBottom(90));
+    inputMeter.setBounds(left.reduced(26, 8));
+
+    auto right = bounds.removeFromRight(76);
+    lookahead.setBounds(right.removeFromTop(90));
+    oversamplingLabel.setBounds(right.removeFromTop(16));
+    oversampling.setBounds(right.removeFromTop(24));
+    oversamplingQuality.setBounds(right.removeFromTop(24));
+    outputGain.setBounds(right.removeFromBottom(90));
+    outputMeter.setBounds(right.reduced(26, 8));
+
+    spectrum.setBounds(bounds.removeFromTop(140).reduced(0, 2));
+
+    // Each crossover sits above the boundary between the two bands it splits.
+    auto crossoverRow = bounds.removeFromTop(90);
+    auto bandWidth = bounds.getWidth() / bands.size();
+    for (int split = 0; split < crossovers.size(); ++split)
+    {
+        auto centre = bounds.getX() + bandWidth * (split + 1);
+        crossovers[split]->setBounds(juce::Rectangle<int>(centre - 50, crossoverRow.getY(), 100, crossoverRow.getHeight()));
+    }
+
+    for (auto* band : bands)
+        band->setBounds(bounds.removeFromLeft(bandWidth));
+}
+
+void SimpleMBCompAudioProcessorEditor::updateCompareButtons()
+{
+    const auto slot = audioProcessor.getPresetManager().getActiveSlot();
+    compareA.setToggleState(slot == PresetManager::Slot::A, juce::dontSendNotification);
+    compareB.setToggleState(slot == PresetManager::Slot::B, juce::dontSendNotification);
+}
+
+void SimpleMBCompAudioProcessorEditor::timerCallback()
+{
+    // Peaks and bars fall at 24 dB/s when the levels drop or no audio arrives.
+    constexpr auto fallPerTick = 24.f / meterRefreshRateHz;
+
+    SimpleMBCompAudioProcessor::Meters meters;
+    audioProcessor.pullMeters(meters);
+
+    inputMeter.setLevels(meters.input.getPeakDecibels(), meters.input.getRmsDecibels(), fallPerTick);
+    outputMeter.setLevels(meters.output.getPeakDecibels(), meters.output.getRmsDecibels(), fallPerTick);
+
+    for (size_t i = 0; i < static_cast<size_t>(bands.size()); ++i)
+    {
+        auto& band = *bands[static_cast<int>(i)];
+        band.inputMeter.setLevels(meters.bandInput[i].getPeakDecibels(), meters.bandInput[i].getRmsDecibels(), fallPerTick);
+        band.outputMeter.setLevels(meters.bandOutput[i].getPeakDecibels(), meters.bandOutput[i].getRmsDecibels(), fallPerTick);
+        band.gainReductionMeter.setGainReduction(meters.getGainReductionDecibels(i), fallPerTick);
+    }
+
+    spectrum.update();
 }
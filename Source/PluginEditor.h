@@ -12,9 +12,95 @@
 #include "PluginProcessor.h"
 
 //==============================================================================
+/** Vertical peak and RMS bar, -60 to +6 dB. */
+struct LevelMeter : juce::Component
+{
+    static constexpr float minDecibels = -60.f;
+    static constexpr float maxDecibels = 6.f;
+
+    /** Rises instantly and falls by at most fallDecibels per call. */
+    void setLevels (float peakDecibels, float rmsDecibels, float fallDecibels);
+    void paint (juce::Graphics& g) override;
+
+private:
+    float peak = minDecibels, rms = minDecibels;
+};
+
+/** Gain reduction bar growing down from 0 to -24 dB. */
+struct GainReductionMeter : juce::Component
+{
+    static constexpr float maxReductionDecibels = -24.f;
+
+    void setGainReduction (float decibels, float releaseDecibels);
+    void paint (juce::Graphics& g) override;
+
+private:
+    float reduction = 0.f;
+};
+
+/** Rotary slider with its parameter name underneath, attached to one parameter. */
+struct LabelledSlider : juce::Component
+{
+    LabelledSlider (juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, const juce::String& labelText);
+    void resized() override;
+
+    juce::Slider slider;
+    juce::Label label;
+
+private:
+    juce::AudioProcessorValueTreeState::SliderAttachment attachment;
+};
+
 /**
+    Spectra of the signal before and after the bands, with the crossover
+    frequencies marked. The analysis runs on the SpectrumAnalyzer's thread;
+    this only draws the latest paths it has finished.
 */
-class SimpleMBCompAudioProcessorEditor  : public juce::AudioProcessorEditor
+struct SpectrumDisplay : juce::Component
+{
+    SpectrumDisplay (SimpleMBCompAudioProcessor& processor);
+
+    /** Fetches new paths, if there are any, and repaints. Message thread. */
+    void update();
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    juce::Rectangle<float> getPlotArea() const;
+
+    std::vector<juce::RangedAudioParameter*> crossoverParams;
+    std::vector<juce::Path> paths;
+    SpectrumAnalyzer analyzer;
+};
+
+/** Controls and meters for one band. */
+struct BandControls : juce::Component
+{
+    BandControls (juce::AudioProcessorValueTreeState& apvts, size_t band);
+    void resized() override;
+
+    juce::Label name;
+    LevelMeter inputMeter, outputMeter;
+    GainReductionMeter gainReductionMeter;
+    LabelledSlider threshold, knee, attack, release;
+    juce::ComboBox ratio;
+    juce::TextButton bypass { "B" }, mute { "M" }, solo { "S" }, sidechain { "SC" };
+
+private:
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment ratioAttachment;
+    juce::AudioProcessorValueTreeState::ButtonAttachment bypassAttachment, muteAttachment, soloAttachment, sidechainAttachment;
+};
+
+//==============================================================================
+/**
+    One column per band with its controls, input/output level and gain
+    reduction, plus the crossovers, the global gains and the spectrum of the
+    input and output. The meters are polled from the processor at a fixed
+    rate on the message thread.
+*/
+class SimpleMBCompAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                          private juce::Timer
 {
 public:
     SimpleMBCompAudioProcessorEditor (SimpleMBCompAudioProcessor&);
@@ -24,10 +110,31 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
+    static constexpr int meterRefreshRateHz = 30;
+
 private:
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     SimpleMBCompAudioProcessor& audioProcessor;
 
+    LabelledSlider inputGain, outputGain, lookahead;
+    juce::Label stereoLinkLabel { {}, "Stereo Link" };
+    juce::ComboBox stereoLink;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment stereoLinkAttachment;
+    juce::Label crossoverModeLabel { {}, "Crossover" };
+    juce::ComboBox crossoverMode;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment crossoverModeAttachment;
+    juce::Label oversamplingLabel { {}, "Oversampling" };
+    juce::ComboBox oversampling, oversamplingQuality;
+    juce::AudioProcessorValueTreeState::ComboBoxAttachment oversamplingAttachment, oversamplingQualityAttachment;
+    juce::TextButton compareA { "A" }, compareB { "B" }, copyToOther { "Copy" };
+    void updateCompareButtons();
+    LevelMeter inputMeter, outputMeter;
+    SpectrumDisplay spectrum;
+    juce::OwnedArray<LabelledSlider> crossovers;
+    juce::OwnedArray<BandControls> bands;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleMBCompAudioProcessorEditor)
 };
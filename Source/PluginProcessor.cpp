@@ -16,6 +16,7 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
@@ -31,62 +32,29 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
         jassert(param != nullptr);
     };
     
-    floatHelper(lowBandComp.attack, Names::Attack_Low_Band);
-    floatHelper(lowBandComp.release, Names::Release_Low_Band);
-    floatHelper(lowBandComp.threshold, Names::Threshold_Low_Band);
-    
-    floatHelper(midBandComp.attack, Names::Attack_Mid_Band);
-    floatHelper(midBandComp.release, Names::Release_Mid_Band);
-    floatHelper(midBandComp.threshold, Names::Threshold_Mid_Band);
-    
-    floatHelper(highBandComp.attack, Names::Attack_High_Band);
-    floatHelper(highBandComp.release, Names::Release_High_Band);
-    floatHelper(highBandComp.threshold, Names::Threshold_High_Band);
-    
-    auto choiceHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
-    {
-        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
-    };
-    
-    choiceHelper(lowBandComp.ratio, Names::Ratio_Low_Band);
-    choiceHelper(midBandComp.ratio, Names::Ratio_Mid_Band);
-    choiceHelper(highBandComp.ratio, Names::Ratio_High_Band);
-    
-    auto boolHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
-    {
-        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
-    };
-    
-    boolHelper(lowBandComp.bypassed, Names::Bypassed_Low_Band);
-    boolHelper(midBandComp.bypassed, Names::Bypassed_Mid_Band);
-    boolHelper(highBandComp.bypassed, Names::Bypassed_High_Band);
-    
-    boolHelper(lowBandComp.mute, Names::Mute_Low_Band);
-    boolHelper(midBandComp.mute, Names::Mute_Mid_Band);
-    boolHelper(highBandComp.mute, Names::Mute_High_Band);
-    
-    boolHelper(lowBandComp.solo, Names:: Solo_Low_Band);
-    boolHelper(midBandComp.solo, Names:: Solo_Mid_Band);
-    boolHelper(highBandComp.solo, Names::Solo_High_Band);
-    
-    // Crossover
-    floatHelper(lowMidCrossover, Names::Low_Mid_Crossover_Freq);
-    floatHelper(midHighCrossover, Names::Mid_High_Crossover_Freq);
+    floatEngine.multibandComp.attachParameters(apvts);
+    doubleEngine.multibandComp.attachParameters(apvts);
+    floatEngine.multibandComp.setStageProfile(&stageProfile);
+    doubleEngine.multibandComp.setStageProfile(&stageProfile);
     
     // Gain
     floatHelper(inputGainParam, Names::Gain_In);
     floatHelper(outputGainParam, Names::Gain_Out);
-    
-    LP0.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP0.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    
-    AP1.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
-    
-    LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    
+    gainChanges.attach(apvts, { params.at(Names::Gain_In), params.at(Names::Gain_Out) });
+    
+    // The attachments call back on the message thread, which is where hosts
+    // expect to hear about latency changes, even when these are automated.
+    for ( auto name : { Names::Lookahead, Names::Oversampling, Names::Oversampling_Quality } )
+        latencyAttachments.add(new juce::ParameterAttachment(*apvts.getParameter(params.at(name)),
+                                                             [this](float) { updateLatency(); }));
+    
+    // The crossover mode also decides whether the kernel designer thread runs.
+    latencyAttachments.add(new juce::ParameterAttachment(*apvts.getParameter(params.at(Names::Crossover_Mode)),
+                                                         [this](float)
+                                                         {
+                                                             updateLatency();
+                                                             updateLinearPhaseDesigner();
+                                                         }));
 }
 
 SimpleMBCompAudioProcessor::~SimpleMBCompAudioProcessor()
@@ -128,27 +96,30 @@ bool SimpleMBCompAudioProcessor::isMidiEffect() const
 
 double SimpleMBCompAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return isUsingDoublePrecision() ? doubleEngine.multibandComp.getTailLengthSeconds()
+                                    : floatEngine.multibandComp.getTailLengthSeconds();
 }
 
 int SimpleMBCompAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    // NB: some hosts don't cope very well if you tell them there are 0 programs,
+    // so this should be at least 1, even before a bank is loaded.
+    return juce::jmax(1, presets.getNumPresets());
 }
 
 int SimpleMBCompAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return juce::jmax(0, presets.getCurrentPreset());
 }
 
 void SimpleMBCompAudioProcessor::setCurrentProgram (int index)
 {
+    presets.recallPreset(index);
 }
 
 const juce::String SimpleMBCompAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return presets.getPresetName(index);
 }
 
 void SimpleMBCompAudioProcessor::changeProgramName (int index, const juce::String& newName)
@@ -163,35 +134,70 @@ void SimpleMBCompAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     spec.numChannels = getTotalNumOutputChannels();
     spec.sampleRate = sampleRate;
     
-    for (auto& compressor : compressors)
-    {
-        compressor.prepare(spec);
-    }
-    
-    inputGain.prepare(spec);
-    outputGain.prepare(spec);
-    inputGain.setRampDurationSeconds(0.05);
-    outputGain.setRampDurationSeconds(0.05);    
+    // Hosts choose the precision before preparing, so only that chain needs its buffers.
+    if ( isUsingDoublePrecision() )
+        prepareEngine(doubleEngine, spec);
+    else
+        prepareEngine(floatEngine, spec);
     
+    updateLatency();
+    updateLinearPhaseDesigner();
+    gainChanges.markDirty();
+    stageProfile.reset();
     
-    LP0.prepare(spec);
-    HP0.prepare(spec);
+    presetMorph.setLengthInSamples(juce::roundToInt(sampleRate * presetMorphSeconds));
     
-    AP1.prepare(spec);
+    meterPublishInterval = static_cast<juce::uint32>(juce::jmax(1.0, sampleRate / 60.0));
+    meterFrame.clear();
+    analyzerSampleRate = sampleRate;
     
-    LP1.prepare(spec);
-    HP1.prepare(spec);
+    // The worker pool is only ever created or destroyed here, never while processing.
+    auto numBandWorkers = juce::jmin(static_cast<int>(numBands) - 1,
+                                     juce::SystemStats::getNumCpus() - 1);
     
-    for (auto& buffer : filterBuffers )
+    if ( parallelBandMode.load() == ParallelBandMode::Off || numBandWorkers < 1 )
+        bandWorkers.reset();
+    else if ( bandWorkers == nullptr )
+        bandWorkers = std::make_unique<BandWorkerPool>(numBandWorkers);
+}
+
+template <typename SampleType>
+void SimpleMBCompAudioProcessor::prepareEngine (Engine<SampleType>& engine, const juce::dsp::ProcessSpec& spec)
+{
+    engine.multibandComp.setChannelGroups(getChannelLinkGroups(getChannelLayoutOfBus(true, 0)));
+    engine.multibandComp.setSidechainChannels(static_cast<size_t>(getNumSidechainChannels()));
+    
+    // Host blocks are worked through in tiles, so the band storage is tile
+    // sized whatever the host's block size. Only the band workers need whole
+    // blocks, to have enough work to share out.
+    auto bandSpec = spec;
+    if ( ! mayProcessBandsInParallel() )
     {
-        buffer.setSize(spec.numChannels, samplesPerBlock);
+        const auto tileSize = MultibandCompressor<numBands, SampleType>::getTileSize(spec.numChannels + static_cast<juce::uint32>(getNumSidechainChannels()));
+        bandSpec.maximumBlockSize = juce::jmin(spec.maximumBlockSize, static_cast<juce::uint32>(tileSize));
     }
+    
+    engine.multibandComp.prepare(bandSpec);
+    
+    engine.inputGain.prepare(spec);
+    engine.outputGain.prepare(spec);
+    engine.inputGain.setRampDurationSeconds(0.05);
+    engine.outputGain.setRampDurationSeconds(0.05);
+}
+
+int SimpleMBCompAudioProcessor::getNumSidechainChannels() const
+{
+    auto* sidechain = getBus(true, 1);
+    return sidechain != nullptr && sidechain->isEnabled() ? sidechain->getNumberOfChannels() : 0;
 }
 
 void SimpleMBCompAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+   #if SIMPLEMBCOMP_RT_AUDIT
+    juce::Logger::writeToLog(RealtimeAudit::getReport().toString());
+   #endif
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -201,12 +207,9 @@ bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any channel count, from mono to immersive and ambisonic layouts. The
+    // layout decides which channels are linked together (see getChannelLinkGroups).
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -220,8 +223,23 @@ bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
 }
 #endif
 
-void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    processEngine(floatEngine, buffer);
+    stageProfile.endBlock();
+}
+
+void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
 {
+    processEngine(doubleEngine, buffer);
+    stageProfile.endBlock();
+}
+
+template <typename SampleType>
+void SimpleMBCompAudioProcessor::processEngine (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer)
+{
+    RealtimeAudit::ScopedAudioThread audioThreadScope;
+    StageProfile::ScopedStage blockTimer (&stageProfile, Profiling::wholeBlock);
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -235,110 +253,178 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    for ( auto& compressor : compressors )
+    auto& multibandComp = engine.multibandComp;
+    
+    // A preset recall morphs values of its own without notifying anybody,
+    // so everything that caches the parameters has to look again.
+    if ( presetMorph.advance(buffer.getNumSamples()) )
     {
-        compressor.updateCompressorSettings();
+        multibandComp.markParametersDirty();
+        gainChanges.markDirty();
     }
-
-    inputGain.setGainDecibels(inputGainParam->get());
-    outputGain.setGainDecibels(outputGainParam->get());
-    
-    applyGain(buffer, inputGain);
     
-//    auto inputGainBlock = juce::dsp::AudioBlock<float>(buffer);
-//    auto inputGainContext = juce::dsp::ProcessContextReplacing<float>(inputGainBlock);
-//    inputGain.setGainDecibels(inputGainParam->get());
-//    inputGain.process(inputGainContext);
+    const ParameterReader read { &presetMorph };
     
-    for ( auto& filterBuffer : filterBuffers )
+    multibandComp.setCrossoverSweepMode(crossoverSweepMode.load());
+    multibandComp.setUseReferenceGainMath(referenceGainMath.load());
+    const auto numRampSteps = static_cast<size_t>(multibandComp.updateParameters(static_cast<size_t>(buffer.getNumSamples()), read));
+
+    if ( gainChanges.checkAndClear() )
     {
-        filterBuffer = buffer;
+        engine.inputGain.setGainDecibels(static_cast<SampleType>(read(*inputGainParam)));
+        engine.outputGain.setGainDecibels(static_cast<SampleType>(read(*outputGainParam)));
     }
     
-    auto lowMidCutoff = lowMidCrossover->get();
-    LP0.setCutoffFrequency(lowMidCutoff);
-    HP0.setCutoffFrequency(lowMidCutoff);
+    // The band storage is sized once in prepareToPlay and never resized here.
+    // It usually holds one tile, see prepareEngine(); the block is worked
+    // through in chunks of that capacity, each one going through every stage
+    // before the next starts. While parameters ramp the block is also split
+    // into one segment per ramp step, so chunks never straddle two steps.
+    const auto capacity = multibandComp.getMaximumBlockSize();
+    const auto numChannels = std::min(static_cast<size_t>(buffer.getNumChannels()),
+                                      multibandComp.getNumChannels());
     
-    auto midHighCutoff = midHighCrossover->get();
-    AP1.setCutoffFrequency(midHighCutoff);
-    LP1.setCutoffFrequency(midHighCutoff);
-    HP1.setCutoffFrequency(midHighCutoff);
+    jassert(capacity > 0);
+    if (capacity == 0 || numChannels == 0)
+        return;
     
-    auto fb0Block = juce::dsp::AudioBlock<float>(filterBuffers[0]);
-    auto fb1Block = juce::dsp::AudioBlock<float>(filterBuffers[1]);
-    auto fb2Block = juce::dsp::AudioBlock<float>(filterBuffers[2]);
+    auto block = juce::dsp::AudioBlock<SampleType>(buffer).getSubsetChannelBlock(0, numChannels);
     
-    auto fb0Context = juce::dsp::ProcessContextReplacing<float>(fb0Block);
-    auto fb1Context = juce::dsp::ProcessContextReplacing<float>(fb1Block);
-    auto fb2Context = juce::dsp::ProcessContextReplacing<float>(fb2Block);
+    // Empty unless the sidechain was enabled when the engine was prepared.
+    juce::dsp::AudioBlock<SampleType> key;
+    const auto numKeyChannels = std::min(static_cast<size_t>(getNumSidechainChannels()),
+                                         multibandComp.getNumSidechainChannels());
     
-    LP0.process(fb0Context);
-    AP1.process(fb0Context);
-    
-    HP0.process(fb1Context);
-    filterBuffers[2] = filterBuffers[1];
+    if ( numKeyChannels > 0 )
+    {
+        const auto firstKeyChannel = getChannelIndexInProcessBlockBuffer(true, 1, 0);
+        if ( firstKeyChannel + static_cast<int>(numKeyChannels) <= buffer.getNumChannels() )
+            key = juce::dsp::AudioBlock<SampleType>(buffer).getSubsetChannelBlock(static_cast<size_t>(firstKeyChannel), numKeyChannels);
+    }
     
-    LP1.process(fb1Context);
-    HP1.process(fb2Context);
+    const auto totalNumSamples = block.getNumSamples();
     
-    for ( size_t i = 0; i < filterBuffers.size(); ++i)
+    for ( size_t step = 0; step < numRampSteps; ++step )
     {
-        compressors[i].process(filterBuffers[i]);
+        if ( step > 0 )
+            multibandComp.advanceParameters();
+        
+        const auto segmentEnd = totalNumSamples * (step + 1) / numRampSteps;
+        
+        for ( auto start = totalNumSamples * step / numRampSteps; start < segmentEnd; start += capacity )
+        {
+            auto numSamples = std::min(capacity, segmentEnd - start);
+            processSubBlock(engine, block.getSubBlock(start, numSamples),
+                            key.getNumChannels() > 0 ? key.getSubBlock(start, numSamples) : key);
+        }
     }
     
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
+    // If the editor has fallen behind the frame is simply dropped.
+    if ( meterFrame.numSamples >= meterPublishInterval )
+    {
+        meterFifo.push(meterFrame);
+        meterFrame.clear();
+    }
+}
+
+template <typename SampleType>
+void SimpleMBCompAudioProcessor::processSubBlock (Engine<SampleType>& engine, juce::dsp::AudioBlock<SampleType> block,
+                                                  juce::dsp::AudioBlock<SampleType> key)
+{
+    auto* meters = meteringEnabled.load(std::memory_order_relaxed) ? &meterFrame : nullptr;
+    const auto analyze = analyzerEnabled.load(std::memory_order_relaxed);
     
-    buffer.clear();
+    if ( meters != nullptr )
+        meters->input.add(block);
     
-    auto addFilterBand = [nc = numChannels, ns = numSamples](auto& inputBuffer, const auto& sourceBuffer )
     {
-        for (auto i = 0; i < nc; ++i)
-        {
-            inputBuffer.addFrom(i, 0, sourceBuffer, i, 0, ns);
-        }
-    };
+        StageProfile::ScopedStage timer (&stageProfile, Profiling::inputGain);
+        applyGain(block, engine.inputGain);
+    }
+    
+    // The analyzer shows what the bands do, so it taps inside the gain stages.
+    if ( analyze )
+        analyzerInput.push(juce::dsp::AudioBlock<const SampleType>(block));
+    
+    auto useWorkers = shouldProcessBandsInParallel(block.getNumSamples() * block.getNumChannels());
+    engine.multibandComp.process(block, useWorkers ? bandWorkers.get() : nullptr, meters, key);
+    
+    if ( analyze )
+        analyzerOutput.push(juce::dsp::AudioBlock<const SampleType>(block));
     
-    auto bandsAreSoloed = false;
-    for ( auto& comp : compressors )
     {
-        if ( comp.solo->get())
-        {
-            bandsAreSoloed = true;
-            break;
-        }
+        StageProfile::ScopedStage timer (&stageProfile, Profiling::outputGain);
+        applyGain(block, engine.outputGain);
     }
     
-    if ( bandsAreSoloed )
+    if ( meters != nullptr )
     {
-        for ( size_t i = 0; i < compressors.size(); ++i)
-        {
-            if ( compressors[i].solo->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
-        }
+        meters->output.add(block);
+        meters->numSamples += static_cast<juce::uint32>(block.getNumSamples());
     }
-    else
+}
+
+void SimpleMBCompAudioProcessor::updateLatency()
+{
+    setLatencySamples(isUsingDoublePrecision() ? doubleEngine.multibandComp.getLatencySamples()
+                                               : floatEngine.multibandComp.getLatencySamples());
+}
+
+void SimpleMBCompAudioProcessor::updateLinearPhaseDesigner()
+{
+    floatEngine.multibandComp.updateLinearPhaseDesigner(! isUsingDoublePrecision());
+    doubleEngine.multibandComp.updateLinearPhaseDesigner(isUsingDoublePrecision());
+}
+
+void SimpleMBCompAudioProcessor::setParallelBandMode (ParallelBandMode newMode)
+{
+    parallelBandMode = newMode;
+}
+
+void SimpleMBCompAudioProcessor::setCrossoverSweepMode (CrossoverSweepMode newMode)
+{
+    crossoverSweepMode = newMode;
+}
+
+void SimpleMBCompAudioProcessor::setMeteringEnabled (bool shouldBeEnabled)
+{
+    meteringEnabled = shouldBeEnabled;
+}
+
+bool SimpleMBCompAudioProcessor::pullMeters (Meters& dest)
+{
+    return meterFifo.pullAll(dest);
+}
+
+void SimpleMBCompAudioProcessor::setAnalyzerEnabled (bool shouldBeEnabled)
+{
+    analyzerEnabled = shouldBeEnabled;
+}
+
+void SimpleMBCompAudioProcessor::setUseReferenceGainMath (bool shouldUseReference)
+{
+    referenceGainMath = shouldUseReference;
+}
+
+bool SimpleMBCompAudioProcessor::mayProcessBandsInParallel() const
+{
+    switch ( parallelBandMode.load() )
     {
-        for ( size_t i = 0; i < compressors.size(); ++i)
-        {
-            if ( ! compressors[i].mute->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
-        }
+        case ParallelBandMode::Off:         return false;
+        case ParallelBandMode::OfflineOnly: return isNonRealtime();
+        case ParallelBandMode::Always:      return true;
     }
     
-    applyGain(buffer, outputGain);
-//    auto outputGainBlock = juce::dsp::AudioBlock<float>(buffer);
-//    auto outputGainContext = juce::dsp::ProcessContextReplacing<float>(outputGainBlock);
-//    outputGain.setGainDecibels(outputGainParam->get());
-//    outputGain.process(outputGainContext);
+    return false;
+}
+
+bool SimpleMBCompAudioProcessor::shouldProcessBandsInParallel (size_t numChannelSamples) const
+{
+    // Below this the dispatch and join cost more than the compressors themselves.
+    if ( bandWorkers == nullptr || numChannelSamples < minChannelSamplesForParallelBands )
+        return false;
     
-//    addFilterBand(buffer, filterBuffers[0]);
-//    addFilterBand(buffer, filterBuffers[1]);
-//    addFilterBand(buffer, filterBuffers[2]);
+    return mayProcessBandsInParallel();
 }
 
 //==============================================================================
@@ -349,24 +435,41 @@ bool SimpleMBCompAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* SimpleMBCompAudioProcessor::createEditor()
 {
-//    return new SimpleMBCompAudioProcessorEditor (*this);
-    return new juce::GenericAudioProcessorEditor(*this);
+    return new SimpleMBCompAudioProcessorEditor (*this);
 }
 
 //==============================================================================
 void SimpleMBCompAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+    juce::MemoryBlock preset;
+    presets.writeState(preset);
+    
+    auto state = apvts.copyState();
+    state.setProperty(presetStateProperty, juce::var(std::move(preset)), nullptr);
+    
     juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    state.writeToStream(mos);
 }
 
 void SimpleMBCompAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid())
+    // Bare binary, as saved by builds before the preset went into the tree.
+    if ( presets.readState(data, static_cast<size_t>(juce::jmax(0, sizeInBytes))) )
+        return;
+    
+    auto tree = juce::ValueTree::readFromData(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)));
+    if ( ! tree.isValid() )
+        return;
+    
+    if ( auto* preset = tree.getProperty(presetStateProperty).getBinaryData() )
     {
-        apvts.replaceState(tree);
+        if ( presets.readState(preset->getData(), preset->getSize()) )
+            return;
     }
+    
+    // Sessions saved before the binary format stored only the APVTS tree.
+    tree.removeProperty(presetStateProperty, nullptr);
+    apvts.replaceState(tree);
 }
 
 
@@ -382,105 +485,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
                                                     0.5f,
                                                     1.f);
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Threshold_Low_Band),
-                                                           params.at(Names::Threshold_Low_Band),
-                                                           juce::NormalisableRange<float>(-60.f, 12.f, 1.f, 1.f),
-                                                           0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Threshold_Mid_Band),
-                                                           params.at(Names::Threshold_Mid_Band),
-                                                           juce::NormalisableRange<float>(-60.f, 12.f, 1.f, 1.f),
-                                                           0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Threshold_High_Band),
-                                                           params.at(Names::Threshold_High_Band),
-                                                           juce::NormalisableRange<float>(-60.f, 12.f, 1.f, 1.f),
-                                                           0.f));
-    
-    auto attackReleaseRange =  juce::NormalisableRange<float>( 5.f, 500.f, 1.f, 1.f );
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Attack_Low_Band),
-                                                           params.at(Names::Attack_Low_Band),
-                                                           attackReleaseRange,
-                                                           50.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Attack_Mid_Band),
-                                                           params.at(Names::Attack_Mid_Band),
-                                                           attackReleaseRange,
-                                                           50.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Attack_High_Band),
-                                                           params.at(Names::Attack_High_Band),
-                                                           attackReleaseRange,
-                                                           50.f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Release_Low_Band),
-                                                           params.at(Names::Release_Low_Band),
-                                                           attackReleaseRange,
-                                                           250.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Release_Mid_Band),
-                                                           params.at(Names::Release_Mid_Band),
-                                                           attackReleaseRange,
-                                                           250.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Release_High_Band),
-                                                           params.at(Names::Release_High_Band),
-                                                           attackReleaseRange,
-                                                           250.f));
-    
-    juce::StringArray strArray;
-    std::vector<double> threshVec = {1.0, 2.0, 3.0, 5.0, 8.0, 13.0, 21.0, 34.0, 55.0, 89.0};
-    for (auto thresh : threshVec)
-    {
-        strArray.add(juce::String(thresh, 1));
-    }
-    
-    layout.add(std::make_unique<juce::AudioParameterChoice>(params.at(Names::Ratio_Low_Band),
-                                                            params.at(Names::Ratio_Low_Band),
-                                                            strArray,
-                                                            2));
-    layout.add(std::make_unique<juce::AudioParameterChoice>(params.at(Names::Ratio_Mid_Band),
-                                                            params.at(Names::Ratio_Mid_Band),
-                                                            strArray,
-                                                            2));
-    layout.add(std::make_unique<juce::AudioParameterChoice>(params.at(Names::Ratio_High_Band),
-                                                            params.at(Names::Ratio_High_Band),
-                                                            strArray,
-                                                            2));
-    
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Bypassed_Low_Band),
-                                                          params.at(Names::Bypassed_Low_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Bypassed_Mid_Band),
-                                                          params.at(Names::Bypassed_Mid_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Bypassed_High_Band),
-                                                          params.at(Names::Bypassed_High_Band),
-                                                          false));
-    
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Mute_Low_Band),
-                                                          params.at(Names::Mute_Low_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Mute_Mid_Band),
-                                                          params.at(Names::Mute_Mid_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Mute_High_Band),
-                                                          params.at(Names::Mute_High_Band),
-                                                          false));
-    
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Solo_Low_Band),
-                                                          params.at(Names::Solo_Low_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Solo_Mid_Band),
-                                                          params.at(Names::Solo_Mid_Band),
-                                                          false));
-    layout.add(std::make_unique<juce::AudioParameterBool>(params.at(Names::Solo_High_Band),
-                                                          params.at(Names::Solo_High_Band),
-                                                          false));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Low_Mid_Crossover_Freq),
-                                                           params.at(Names::Low_Mid_Crossover_Freq),
-                                                           juce::NormalisableRange<float>(20.f, 999.f, 1.f, 1.f),
-                                                           500.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Mid_High_Crossover_Freq),
-                                                           params.at(Names::Mid_High_Crossover_Freq),
-                                                           juce::NormalisableRange<float>(1000.f, 20000.f, 1.f, 1.f),
-                                                           3000.f));
+    MultibandComp::addParameters(layout);
     
     layout.add(std::make_unique<juce::AudioParameterFloat>(params.at(Names::Gain_In),
                                                            params.at(Names::Gain_In),
@@ -491,6 +496,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
                                                            gainRange,
                                                            0.f));
     
+    MultibandComp::addLateParameters(layout);
+    
     return layout;
 }
 
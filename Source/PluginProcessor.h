@@ -9,8 +9,19 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "CompressorBand.h"
+#include "Metering.h"
+#include "MultibandCompressor.h"
 #include "ParamInfo.h"
+#include "Presets.h"
+#include "SpectrumAnalyzer.h"
+#include "RealtimeAudit.h"
+#include "StageProfile.h"
+
+// The band count is fixed at compile time; build with e.g.
+// SIMPLEMBCOMP_NUM_BANDS=4 for a four band variant.
+#ifndef SIMPLEMBCOMP_NUM_BANDS
+ #define SIMPLEMBCOMP_NUM_BANDS 3
+#endif
 
 //==============================================================================
 /**
@@ -31,6 +42,10 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    /** The whole DSP chain exists in both precisions, so double hosts run it natively. */
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -55,37 +70,154 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    /** Runs the band compressors on a small worker pool for large blocks.
+        Takes effect at the next prepareToPlay. Without it (and in realtime
+        with OfflineOnly, the default) blocks are processed in small tiles.
+    */
+    enum class ParallelBandMode
+    {
+        Off,
+        OfflineOnly,
+        Always
+    };
+    
+    void setParallelBandMode (ParallelBandMode newMode);
+    
+    /** Smoothed (the default) glides the crossovers to new cutoffs sample by
+        sample; Stepped jumps at each parameter ramp step (see
+        MultibandCompressor::updateParameters()), bit exact with the old filter tree.
+    */
+    void setCrossoverSweepMode (CrossoverSweepMode newMode);
+    
+    /** Computes the compressor gains with std::log2/exp2/pow instead of the
+        polynomial approximations, to validate them. Much slower.
+    */
+    void setUseReferenceGainMath (bool shouldUseReference);
+    
+    static constexpr size_t numBands = SIMPLEMBCOMP_NUM_BANDS;
+    using MultibandComp = MultibandCompressor<numBands>;
+    
+    //==============================================================================
+    using Meters = MeterFrame<numBands>;
+    
+    /** Levels are only measured while enabled; the editor turns this on while it is open. */
+    void setMeteringEnabled (bool shouldBeEnabled);
+    
+    /** Merges every meter frame published since the last call into dest.
+        Wait-free, and only meant to be called from one thread (the editor's timer).
+    */
+    bool pullMeters (Meters& dest);
+    
+    /** The signal going into and coming out of the bands, i.e. after the
+        input gain and before the output gain, downmixed to mono, only while
+        enabled. The editor turns this on while its spectrum display is open.
+    */
+    void setAnalyzerEnabled (bool shouldBeEnabled);
+    AnalyzerFifo& getAnalyzerInput() noexcept { return analyzerInput; }
+    AnalyzerFifo& getAnalyzerOutput() noexcept { return analyzerOutput; }
+    double getAnalyzerSampleRate() const noexcept { return analyzerSampleRate.load(std::memory_order_relaxed); }
+    
+    //==============================================================================
+    using StageProfile = Profiling::StageProfile<numBands>;
+    
+    /** Per-stage processing times since the last prepareToPlay. Empty unless
+        built with SIMPLEMBCOMP_PROFILE=1. Safe to read from any thread.
+    */
+    const StageProfile& getStageProfile() const noexcept { return stageProfile; }
+    
     using APVTS = juce::AudioProcessorValueTreeState;
     static APVTS::ParameterLayout createParameterLayout();
     APVTS apvts {*this, nullptr, "Parameters", createParameterLayout()};
     
+    /** Presets, the preset bank and A/B compare. Message thread only. */
+    PresetManager& getPresetManager() noexcept { return presets; }
+
 private:
-    std::array<CompressorBand, 3> compressors;
-    CompressorBand& lowBandComp = compressors[0];
-    CompressorBand& midBandComp = compressors[1];
-    CompressorBand& highBandComp = compressors[2];
+    // Declared after apvts: the manager collects the parameters when it is constructed.
+    SnapshotMorph presetMorph;
+    PresetManager presets { *this, presetMorph };
+    static constexpr double presetMorphSeconds = 0.05;
+    
+    // The binary preset, as a property of the APVTS tree saved as the plugin
+    // state; builds that predate the binary format still load the tree.
+    static inline const juce::Identifier presetStateProperty { "PresetData" };
+    
+    
+    // One complete chain per precision. Only the one matching
+    // isUsingDoublePrecision() is prepared and run.
+    template <typename SampleType>
+    struct Engine
+    {
+        MultibandCompressor<numBands, SampleType> multibandComp;
+        juce::dsp::Gain<SampleType> inputGain, outputGain;
+    };
+    
+    Engine<float> floatEngine;
+    Engine<double> doubleEngine;
+    
+    template <typename SampleType>
+    void prepareEngine (Engine<SampleType>& engine, const juce::dsp::ProcessSpec& spec);
+    
+    template <typename SampleType>
+    void processEngine (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer);
     
+    template <typename SampleType>
+    void processSubBlock (Engine<SampleType>& engine, juce::dsp::AudioBlock<SampleType> block,
+                          juce::dsp::AudioBlock<SampleType> key);
     
-    using Filter = juce::dsp::LinkwitzRileyFilter<float>;
-    //      FC0     FC1
-    Filter  LP0,    AP1,
-            HP0,    LP1,
-                    HP1;
+    /** 0 when the sidechain bus is disabled. */
+    int getNumSidechainChannels() const;
     
-    juce::AudioParameterFloat* lowMidCrossover { nullptr };
-    juce::AudioParameterFloat* midHighCrossover { nullptr };
+    std::atomic<ParallelBandMode> parallelBandMode { ParallelBandMode::OfflineOnly };
+    std::unique_ptr<BandWorkerPool> bandWorkers;
     
-    std::array<juce::AudioBuffer<float>, 3> filterBuffers;
+    /** Blocks smaller than this, counted in samples times channels since
+        that is what the band work grows with, stay on the audio thread.
+        At about 6 ns per sample and channel for a band's compressor (float,
+        unlinked, no oversampling), 2048 gives the three bands around 35 us
+        of work. Sharing that out saves some 25 us, against typically 5 to
+        50 us for waking a parked worker, so this is about break-even.
+        Oversampling or a fourth band only make the work larger.
+    */
+    static constexpr size_t minChannelSamplesForParallelBands = 2048;
+    
+    bool shouldProcessBandsInParallel (size_t numChannelSamples) const;
+    
+    /** Whether prepareToPlay has to leave room for whole blocks for the band workers. */
+    bool mayProcessBandsInParallel() const;
+    
+    std::atomic<CrossoverSweepMode> crossoverSweepMode { CrossoverSweepMode::Smoothed };
+    std::atomic<bool> referenceGainMath { false };
+    
+    // Filled on the audio thread and pushed to the FIFO about 60 times a second.
+    std::atomic<bool> meteringEnabled { false };
+    Meters meterFrame;
+    MeterFifo<Meters, 128> meterFifo;
+    juce::uint32 meterPublishInterval { 1024 };
+    
+    std::atomic<bool> analyzerEnabled { false };
+    std::atomic<double> analyzerSampleRate { 44100.0 };
+    AnalyzerFifo analyzerInput, analyzerOutput;
+    
+    StageProfile stageProfile;
     
-    juce::dsp::Gain<float> inputGain, outputGain;
     juce::AudioParameterFloat* inputGainParam { nullptr };
     juce::AudioParameterFloat* outputGainParam { nullptr };
+    ParameterChangeFlag gainChanges;
+    
+    // Keep the reported latency in step with the parameters that change it.
+    juce::OwnedArray<juce::ParameterAttachment> latencyAttachments;
+    void updateLatency();
+    
+    /** Runs the linear-phase kernel designer only in the engine in use, and
+        only while the linear-phase crossover is selected. Message thread.
+    */
+    void updateLinearPhaseDesigner();
     
-    template <typename T, typename U>
-    void applyGain (T& buffer, U& gain)
+    template <typename SampleType>
+    void applyGain (juce::dsp::AudioBlock<SampleType> block, juce::dsp::Gain<SampleType>& gain)
     {
-        auto GainBlock = juce::dsp::AudioBlock<float>(buffer);
-        auto GainContext = juce::dsp::ProcessContextReplacing<float>(GainBlock);
+        auto GainContext = juce::dsp::ProcessContextReplacing<SampleType>(block);
         gain.process(GainContext);
     }
     
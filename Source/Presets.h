@@ -0,0 +1,426 @@
+/*
+  ==============================================================================
+
+    Presets.h
+    Created: 17 Oct 2026 4:30:34am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SnapshotMorph.h"
+
+/** The normalised value of every parameter, in AudioProcessor::getParameters() order. */
+struct ParameterSnapshot
+{
+    juce::String name;
+    std::vector<float> values;
+};
+
+/*
+    Binary format for the plugin state, single presets and banks; all three
+    are a list of snapshots. All numbers are little endian:
+
+        int32   magic, "SBMP"
+        int32   version
+        int32   number of parameter IDs, then each ID as a null terminated UTF-8 string
+        int32   number of snapshots, then for each one
+                    its name as a null terminated UTF-8 string
+                    one float32 normalised value per parameter ID
+
+    The IDs are stored once per file, so a snapshot costs four bytes per
+    parameter. Reading maps the stored IDs onto the current ones: values of
+    parameters that no longer exist are dropped, and parameters added since
+    the file was written get their defaults.
+*/
+namespace PresetFormat
+{
+    constexpr int magic = 0x504d4253;
+    constexpr int version = 1;
+
+    inline void write (juce::OutputStream& out, const juce::StringArray& parameterIDs,
+                       const std::vector<ParameterSnapshot>& snapshots)
+    {
+        out.writeInt(magic);
+        out.writeInt(version);
+
+        out.writeInt(parameterIDs.size());
+        for (auto& id : parameterIDs)
+            out.writeString(id);
+
+        out.writeInt(static_cast<int>(snapshots.size()));
+        for (auto& snapshot : snapshots)
+        {
+            jassert(snapshot.values.size() == static_cast<size_t>(parameterIDs.size()));
+
+            out.writeString(snapshot.name);
+            for (auto value : snapshot.values)
+                out.writeFloat(value);
+        }
+    }
+
+    inline bool isPresetData (const void* data, size_t sizeInBytes)
+    {
+        return sizeInBytes >= sizeof(int)
+            && juce::ByteOrder::littleEndianInt(data) == static_cast<juce::uint32>(magic);
+    }
+
+    // The readers below check there is enough left of the stream before
+    // every read, since InputStream quietly returns zeros past its end.
+    inline bool readInt (juce::InputStream& in, int& dest)
+    {
+        if (in.getNumBytesRemaining() < static_cast<juce::int64>(sizeof(int)))
+            return false;
+
+        dest = in.readInt();
+        return true;
+    }
+
+    inline bool readFloat (juce::InputStream& in, float& dest)
+    {
+        if (in.getNumBytesRemaining() < static_cast<juce::int64>(sizeof(float)))
+            return false;
+
+        dest = in.readFloat();
+        return true;
+    }
+
+    /** False if the stream ends before the string's terminator. */
+    inline bool readString (juce::InputStream& in, juce::String& dest)
+    {
+        juce::MemoryOutputStream bytes;
+
+        while (in.getNumBytesRemaining() > 0)
+        {
+            const auto c = in.readByte();
+            if (c == 0)
+            {
+                dest = juce::String::fromUTF8(static_cast<const char*>(bytes.getData()), static_cast<int>(bytes.getDataSize()));
+                return true;
+            }
+
+            bytes.writeByte(c);
+        }
+
+        return false;
+    }
+
+    /** Leaves dest alone and returns false if the data is not a complete,
+        valid preset file: one that ends early or holds a NaN is rejected.
+    */
+    inline bool read (juce::InputStream& in, const juce::StringArray& parameterIDs, const std::vector<float>& defaults,
+                      std::vector<ParameterSnapshot>& dest)
+    {
+        jassert(defaults.size() == static_cast<size_t>(parameterIDs.size()));
+
+        int fileMagic = 0, fileVersion = 0, numIDs = 0, numSnapshots = 0;
+
+        if (! readInt(in, fileMagic) || fileMagic != magic)
+            return false;
+
+        if (! readInt(in, fileVersion) || fileVersion < 1 || fileVersion > version)
+            return false;
+
+        if (! readInt(in, numIDs) || numIDs < 0 || numIDs > 65536)
+            return false;
+
+        std::vector<int> parameterIndex (static_cast<size_t>(numIDs));
+        for (auto& index : parameterIndex)
+        {
+            juce::String id;
+            if (! readString(in, id))
+                return false;
+
+            index = parameterIDs.indexOf(id);
+        }
+
+        // Every snapshot needs at least its name's terminator and its values.
+        if (! readInt(in, numSnapshots) || numSnapshots < 0
+            || static_cast<juce::int64>(numSnapshots) * (numIDs * 4 + 1) > in.getNumBytesRemaining())
+            return false;
+
+        std::vector<ParameterSnapshot> snapshots (static_cast<size_t>(numSnapshots));
+        for (auto& snapshot : snapshots)
+        {
+            if (! readString(in, snapshot.name))
+                return false;
+
+            snapshot.values = defaults;
+
+            for (auto index : parameterIndex)
+            {
+                float value = 0.f;
+                if (! readFloat(in, value) || std::isnan(value))
+                    return false;
+
+                if (index >= 0)
+                    snapshot.values[static_cast<size_t>(index)] = juce::jlimit(0.f, 1.f, value);
+            }
+        }
+
+        dest = std::move(snapshots);
+        return true;
+    }
+}
+
+/*
+    Presets, a bank of them and A/B compare, on the message thread.
+
+    Recalling a preset while audio is running hands it to a SnapshotMorph,
+    which moves the DSP there on the audio thread without touching the
+    parameters. Once the morph is done the parameters are set here, each
+    one that changed inside its own change gesture. If the audio thread
+    doesn't pick the preset up (nothing is playing) it is applied directly
+    instead.
+*/
+class PresetManager : private juce::Timer
+{
+public:
+    enum class Slot { A, B };
+
+    PresetManager (juce::AudioProcessor& processor, SnapshotMorph& morphToUse)
+        : morph(morphToUse)
+    {
+        for (auto* param : processor.getParameters())
+        {
+            auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+            jassert(withID != nullptr);
+
+            parameters.add(param);
+            parameterIDs.add(withID != nullptr ? withID->paramID : juce::String(param->getParameterIndex()));
+            defaults.push_back(param->getDefaultValue());
+        }
+
+        morph.prepare(parameters);
+    }
+
+    ~PresetManager() override
+    {
+        stopTimer();
+    }
+
+    const juce::StringArray& getParameterIDs() const noexcept { return parameterIDs; }
+
+    /** The current settings; during a morph, the ones it is heading for. */
+    ParameterSnapshot capture (const juce::String& name = {}) const
+    {
+        ParameterSnapshot snapshot { name, {} };
+
+        if (morphGeneration != 0)
+        {
+            snapshot.values = target.values;
+            return snapshot;
+        }
+
+        snapshot.values.reserve(static_cast<size_t>(parameters.size()));
+
+        for (auto* param : parameters)
+            snapshot.values.push_back(param->getValue());
+
+        return snapshot;
+    }
+
+    /** Sets the parameters at once, telling the host about each one that changes. */
+    void apply (const ParameterSnapshot& snapshot)
+    {
+        cancelMorph();
+        setParameters(snapshot);
+    }
+
+    /** Morphs to the snapshot while audio is running, otherwise applies it. */
+    void recall (const ParameterSnapshot& snapshot)
+    {
+        jassert(snapshot.values.size() == static_cast<size_t>(parameters.size()));
+
+        // A finished morph's parameters are set before the next one starts
+        // from them; one still running is simply taken over.
+        if (morph.hasFinished(morphGeneration))
+            finishMorph();
+
+        target = snapshot;
+        morphGeneration = morph.publish(target.values);
+
+        ticksPending = 0;
+        startTimerHz(timerRateHz);
+    }
+
+    //==============================================================================
+    Slot getActiveSlot() const noexcept { return activeSlot; }
+
+    /** Keeps the current settings in the active slot and recalls the other one.
+        The first switch to an empty slot just copies the current settings there.
+    */
+    void switchTo (Slot slot)
+    {
+        if (slot == activeSlot)
+            return;
+
+        getSlot(activeSlot) = capture();
+        activeSlot = slot;
+
+        if (getSlot(slot).values.empty())
+            getSlot(slot) = getSlot(slot == Slot::A ? Slot::B : Slot::A);
+        else
+            recall(getSlot(slot));
+    }
+
+    /** Overwrites the inactive slot with the current settings. */
+    void copyToOtherSlot()
+    {
+        getSlot(activeSlot == Slot::A ? Slot::B : Slot::A) = capture();
+    }
+
+    //==============================================================================
+    int getNumPresets() const noexcept { return static_cast<int>(bank.size()); }
+    int getCurrentPreset() const noexcept { return currentPreset; }
+
+    juce::String getPresetName (int index) const
+    {
+        return juce::isPositiveAndBelow(index, getNumPresets()) ? bank[static_cast<size_t>(index)].name : juce::String();
+    }
+
+    void recallPreset (int index)
+    {
+        if ( ! juce::isPositiveAndBelow(index, getNumPresets()) )
+            return;
+
+        currentPreset = index;
+        recall(bank[static_cast<size_t>(index)]);
+    }
+
+    /** Adds the current settings to the end of the bank. */
+    void storePreset (const juce::String& name)
+    {
+        bank.push_back(capture(name));
+        currentPreset = getNumPresets() - 1;
+    }
+
+    bool loadBank (const void* data, size_t sizeInBytes)
+    {
+        juce::MemoryInputStream in (data, sizeInBytes, false);
+        if ( ! PresetFormat::read(in, parameterIDs, defaults, bank) )
+            return false;
+
+        currentPreset = -1;
+        return true;
+    }
+
+    void saveBank (juce::MemoryBlock& dest) const
+    {
+        juce::MemoryOutputStream out (dest, false);
+        PresetFormat::write(out, parameterIDs, bank);
+    }
+
+    bool loadBank (const juce::File& file)
+    {
+        juce::MemoryBlock data;
+        return file.loadFileAsData(data) && loadBank(data.getData(), data.getSize());
+    }
+
+    bool saveBank (const juce::File& file) const
+    {
+        juce::MemoryBlock data;
+        saveBank(data);
+        return file.replaceWithData(data.getData(), data.getSize());
+    }
+
+    //==============================================================================
+    /** The plugin state: the current settings as a one-snapshot preset file. */
+    void writeState (juce::MemoryBlock& dest) const
+    {
+        juce::MemoryOutputStream out (dest, false);
+        PresetFormat::write(out, parameterIDs, { capture() });
+    }
+
+    /** Applies the state at once. False if it isn't in the preset format. */
+    bool readState (const void* data, size_t sizeInBytes)
+    {
+        if ( ! PresetFormat::isPresetData(data, sizeInBytes) )
+            return false;
+
+        std::vector<ParameterSnapshot> snapshots;
+        juce::MemoryInputStream in (data, sizeInBytes, false);
+        if ( ! PresetFormat::read(in, parameterIDs, defaults, snapshots) || snapshots.empty() )
+            return false;
+
+        apply(snapshots.front());
+        return true;
+    }
+
+private:
+    static constexpr int timerRateHz = 30;
+    // About 200 ms without a processBlock call to take the snapshot.
+    static constexpr int maxTicksPending = timerRateHz / 5;
+
+    void timerCallback() override
+    {
+        if (morph.hasFinished(morphGeneration))
+        {
+            finishMorph();
+            return;
+        }
+
+        if (morph.isPending() && ++ticksPending > maxTicksPending && morph.cancel())
+        {
+            stopTimer();
+            apply(target);
+        }
+    }
+
+    // The caller sets the parameters next, so whatever the morph had got to doesn't matter.
+    void cancelMorph()
+    {
+        stopTimer();
+        morph.cancel();
+        morph.release();
+        morphGeneration = 0;
+    }
+
+    // The DSP has reached the target, so the parameters can follow it there.
+    void finishMorph()
+    {
+        stopTimer();
+        setParameters(target);
+        morph.release();
+        morphGeneration = 0;
+    }
+
+    void setParameters (const ParameterSnapshot& snapshot)
+    {
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            const auto value = snapshot.values[static_cast<size_t>(i)];
+            if (parameters[i]->getValue() != value)
+            {
+                parameters[i]->beginChangeGesture();
+                parameters[i]->setValueNotifyingHost(value);
+                parameters[i]->endChangeGesture();
+            }
+        }
+    }
+
+    ParameterSnapshot& getSlot (Slot slot) noexcept
+    {
+        return slot == Slot::A ? slotA : slotB;
+    }
+
+    SnapshotMorph& morph;
+
+    juce::Array<juce::AudioProcessorParameter*> parameters;
+    juce::StringArray parameterIDs;
+    std::vector<float> defaults;
+
+    ParameterSnapshot target;
+    int morphGeneration = 0;   // 0 while no morph is waiting to be finished
+    int ticksPending = 0;
+
+    Slot activeSlot = Slot::A;
+    ParameterSnapshot slotA, slotB;
+
+    std::vector<ParameterSnapshot> bank;
+    int currentPreset = -1;
+
+    JUCE_DECLARE_NON_COPYABLE (PresetManager)
+};
@@ -0,0 +1,408 @@
+/*
+  ==============================================================================
+
+    RealtimeAudit.cpp
+    Created: 17 Oct 2026 3:45:33am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "RealtimeAudit.h"
+
+juce::String RealtimeAudit::Report::toString() const
+{
+    juce::String s;
+    s << "RT audit: " << (isClean() ? "clean" : "VIOLATIONS")
+      << " (" << juce::String((juce::int64) blocksAudited) << " blocks, "
+      << juce::String((juce::int64) allocations) << " allocations, "
+      << juce::String((juce::int64) deallocations) << " deallocations, "
+      << juce::String((juce::int64) locks) << " locks)";
+    return s;
+}
+
+#if SIMPLEMBCOMP_RT_AUDIT
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace
+{
+    // Plain globals only: these are touched from inside operator new and
+    // pthread_mutex_lock, so nothing here may allocate, lock or need a guard.
+    thread_local int audioThreadDepth = 0;
+
+    std::atomic<juce::uint64> allocationCount { 0 };
+    std::atomic<juce::uint64> deallocationCount { 0 };
+    std::atomic<juce::uint64> lockCount { 0 };
+    std::atomic<juce::uint64> blockCount { 0 };
+
+    inline bool isOnAudioThread() noexcept { return audioThreadDepth > 0; }
+
+    inline void trap() noexcept
+    {
+       #if JUCE_DEBUG
+        // The debugger check allocates, and those allocations aren't the audio code's.
+        const auto depth = std::exchange(audioThreadDepth, 0);
+        if (juce::juce_isRunningUnderDebugger())
+            JUCE_BREAK_IN_DEBUGGER;
+        audioThreadDepth = depth;
+       #endif
+    }
+
+    inline void noteAllocation() noexcept
+    {
+        if (isOnAudioThread())
+        {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            trap();
+        }
+    }
+
+    inline void noteDeallocation() noexcept
+    {
+        if (isOnAudioThread())
+        {
+            deallocationCount.fetch_add(1, std::memory_order_relaxed);
+            trap();
+        }
+    }
+
+   #if JUCE_LINUX
+    //==============================================================================
+    // The allocator behind the C allocation hooks further down, found with
+    // dlsym(RTLD_NEXT) like the lock hooks. dlsym can itself allocate before
+    // it has returned, so the few allocations made while it runs come from a
+    // static arena that is never freed.
+    using MallocFn = void* (*) (std::size_t);
+    using CallocFn = void* (*) (std::size_t, std::size_t);
+    using ReallocFn = void* (*) (void*, std::size_t);
+    using FreeFn = void (*) (void*);
+
+    struct SystemAllocator
+    {
+        MallocFn malloc = nullptr;
+        CallocFn calloc = nullptr;
+        ReallocFn realloc = nullptr;
+        FreeFn free = nullptr;
+    };
+
+    SystemAllocator systemAllocator;
+    std::atomic<bool> systemAllocatorResolved { false };
+    std::atomic<bool> resolvingSystemAllocator { false };
+
+    alignas(std::max_align_t) char bootstrapArena[8192];
+    std::atomic<std::size_t> bootstrapArenaUsed { 0 };
+
+    /** Null while dlsym is still looking the functions up. */
+    const SystemAllocator* getSystemAllocator() noexcept
+    {
+        if (systemAllocatorResolved.load(std::memory_order_acquire))
+            return &systemAllocator;
+
+        if (resolvingSystemAllocator.exchange(true))
+            return nullptr;
+
+        systemAllocator.malloc = reinterpret_cast<MallocFn>(dlsym(RTLD_NEXT, "malloc"));
+        systemAllocator.calloc = reinterpret_cast<CallocFn>(dlsym(RTLD_NEXT, "calloc"));
+        systemAllocator.realloc = reinterpret_cast<ReallocFn>(dlsym(RTLD_NEXT, "realloc"));
+        systemAllocator.free = reinterpret_cast<FreeFn>(dlsym(RTLD_NEXT, "free"));
+        systemAllocatorResolved.store(true, std::memory_order_release);
+        return &systemAllocator;
+    }
+
+    /** Zeroed, as the arena is static and never reused. */
+    void* bootstrapAllocate (std::size_t size) noexcept
+    {
+        constexpr auto alignment = alignof(std::max_align_t);
+        size = (size + alignment - 1) & ~(alignment - 1);
+
+        const auto offset = bootstrapArenaUsed.fetch_add(size);
+        return offset + size <= sizeof(bootstrapArena) ? bootstrapArena + offset : nullptr;
+    }
+
+    bool isBootstrapPointer (const void* ptr) noexcept
+    {
+        const auto* p = static_cast<const char*>(ptr);
+        return p >= bootstrapArena && p < bootstrapArena + sizeof(bootstrapArena);
+    }
+
+    // malloc and free are hooked themselves, so the C++ hooks go straight to
+    // the system allocator rather than counting everything twice.
+    void* systemMalloc (std::size_t size) noexcept
+    {
+        const auto* allocator = getSystemAllocator();
+        return allocator != nullptr ? allocator->malloc(size) : bootstrapAllocate(size);
+    }
+
+    void systemFree (void* ptr) noexcept
+    {
+        if (isBootstrapPointer(ptr))
+            return;
+
+        if (const auto* allocator = getSystemAllocator())
+            allocator->free(ptr);
+    }
+   #else
+    void* systemMalloc (std::size_t size) noexcept  { return std::malloc(size); }
+    void systemFree (void* ptr) noexcept            { std::free(ptr); }
+   #endif
+
+    void* auditedMalloc (std::size_t size) noexcept
+    {
+        noteAllocation();
+        return systemMalloc(size == 0 ? 1 : size);
+    }
+
+    void* auditedAlignedMalloc (std::size_t size, std::size_t alignment) noexcept
+    {
+        noteAllocation();
+        size = size == 0 ? alignment : size;
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, std::max(alignment, sizeof(void*)), size) != 0)
+            return nullptr;
+        return ptr;
+       #endif
+    }
+
+    void auditedFree (void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        noteDeallocation();
+        systemFree(ptr);
+    }
+
+    void auditedAlignedFree (void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        noteDeallocation();
+       #if JUCE_WINDOWS
+        _aligned_free(ptr);
+       #else
+        systemFree(ptr);
+       #endif
+    }
+}
+
+RealtimeAudit::Report RealtimeAudit::getReport()
+{
+    Report r;
+    r.allocations = allocationCount.load();
+    r.deallocations = deallocationCount.load();
+    r.locks = lockCount.load();
+    r.blocksAudited = blockCount.load();
+    return r;
+}
+
+void RealtimeAudit::resetReport()
+{
+    allocationCount = 0;
+    deallocationCount = 0;
+    lockCount = 0;
+    blockCount = 0;
+}
+
+bool RealtimeAudit::catchesAllocations()
+{
+    const auto before = getReport();
+
+    {
+        ScopedAudioThread audioThread;
+        juce::AudioBuffer<float> buffer;
+        buffer.setSize(2, 512);
+
+        // Keeps the compiler from removing the allocation as unused.
+        static const void* volatile escape = nullptr;
+        escape = buffer.getReadPointer(0);
+    }
+
+    const auto after = getReport();
+
+    // The test allocation isn't a violation, so it comes off the counts again.
+    allocationCount = before.allocations;
+    deallocationCount = before.deallocations;
+    lockCount = before.locks;
+    blockCount = before.blocksAudited;
+
+    return after.allocations > before.allocations && after.deallocations > before.deallocations;
+}
+
+RealtimeAudit::ScopedAudioThread::ScopedAudioThread (bool countsAsBlock)
+{
+    if (audioThreadDepth++ == 0 && countsAsBlock)
+        blockCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+RealtimeAudit::ScopedAudioThread::~ScopedAudioThread()
+{
+    --audioThreadDepth;
+}
+
+//==============================================================================
+// Global allocation hooks
+void* operator new (std::size_t size)
+{
+    if (auto* ptr = auditedMalloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+    if (auto* ptr = auditedMalloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept    { return auditedMalloc(size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept  { return auditedMalloc(size); }
+
+void operator delete (void* ptr) noexcept                                { auditedFree(ptr); }
+void operator delete[] (void* ptr) noexcept                              { auditedFree(ptr); }
+void operator delete (void* ptr, std::size_t) noexcept                   { auditedFree(ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept                 { auditedFree(ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept         { auditedFree(ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept       { auditedFree(ptr); }
+
+void* operator new (std::size_t size, std::align_val_t al)
+{
+    if (auto* ptr = auditedAlignedMalloc(size, static_cast<std::size_t>(al)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size, std::align_val_t al)
+{
+    if (auto* ptr = auditedAlignedMalloc(size, static_cast<std::size_t>(al)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return auditedAlignedMalloc(size, static_cast<std::size_t>(al));
+}
+
+void* operator new[] (std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return auditedAlignedMalloc(size, static_cast<std::size_t>(al));
+}
+
+void operator delete (void* ptr, std::align_val_t) noexcept                          { auditedAlignedFree(ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept                        { auditedAlignedFree(ptr); }
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept             { auditedAlignedFree(ptr); }
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept           { auditedAlignedFree(ptr); }
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept   { auditedAlignedFree(ptr); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { auditedAlignedFree(ptr); }
+
+//==============================================================================
+// C allocation hooks. juce::HeapBlock, and so AudioBuffer::setSize, and any
+// C library allocate with malloc and friends rather than operator new.
+#if JUCE_LINUX
+extern "C" void* malloc (std::size_t size) noexcept
+{
+    noteAllocation();
+    return systemMalloc(size);
+}
+
+extern "C" void* calloc (std::size_t count, std::size_t size) noexcept
+{
+    noteAllocation();
+
+    if (const auto* allocator = getSystemAllocator())
+        return allocator->calloc(count, size);
+
+    return size == 0 || count <= std::numeric_limits<std::size_t>::max() / size ? bootstrapAllocate(count * size) : nullptr;
+}
+
+extern "C" void* realloc (void* ptr, std::size_t size) noexcept
+{
+    noteAllocation();
+
+    if (ptr != nullptr)
+        noteDeallocation();
+
+    // Moves a block out of the bootstrap arena, copying as much as the arena could hold.
+    if (isBootstrapPointer(ptr))
+    {
+        auto* moved = systemMalloc(size);
+        if (moved != nullptr)
+            std::memcpy(moved, ptr, juce::jmin(size, static_cast<std::size_t>(bootstrapArena + sizeof(bootstrapArena) - static_cast<char*>(ptr))));
+        return moved;
+    }
+
+    const auto* allocator = getSystemAllocator();
+    return allocator != nullptr ? allocator->realloc(ptr, size) : bootstrapAllocate(size);
+}
+
+extern "C" void free (void* ptr) noexcept
+{
+    if (ptr == nullptr || isBootstrapPointer(ptr))
+        return;
+
+    noteDeallocation();
+    systemFree(ptr);
+}
+#endif
+
+//==============================================================================
+// Lock hooks. Interposing pthread_mutex_lock catches std::mutex,
+// juce::CriticalSection and anything else built on pthreads.
+#if JUCE_LINUX
+namespace
+{
+    using MutexFn = int (*) (pthread_mutex_t*);
+
+    MutexFn resolve (std::atomic<MutexFn>& cache, const char* name) noexcept
+    {
+        auto fn = cache.load(std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = reinterpret_cast<MutexFn>(dlsym(RTLD_NEXT, name));
+            cache.store(fn, std::memory_order_release);
+        }
+        return fn;
+    }
+
+    std::atomic<MutexFn> realLock { nullptr };
+    std::atomic<MutexFn> realTryLock { nullptr };
+
+    inline void noteLock() noexcept
+    {
+        if (isOnAudioThread())
+        {
+            lockCount.fetch_add(1, std::memory_order_relaxed);
+            trap();
+        }
+    }
+}
+
+extern "C" int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+{
+    noteLock();
+    return resolve(realLock, "pthread_mutex_lock")(mutex);
+}
+
+extern "C" int pthread_mutex_trylock (pthread_mutex_t* mutex) noexcept
+{
+    noteLock();
+    return resolve(realTryLock, "pthread_mutex_trylock")(mutex);
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    RealtimeAudit.h
+    Created: 17 Oct 2026 3:45:33am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Real-time safety audit mode.
+
+    Build with SIMPLEMBCOMP_RT_AUDIT=1 (the "Audit" configuration in the .jucer
+    does this) and every heap allocation, deallocation or mutex lock made while
+    a ScopedAudioThread is alive on the current thread gets counted.
+    operator new and delete are hooked everywhere; malloc, calloc, realloc,
+    free and the pthread mutex locks only on Linux.
+    In a normal build all of this compiles away to nothing.
+*/
+#ifndef SIMPLEMBCOMP_RT_AUDIT
+ #define SIMPLEMBCOMP_RT_AUDIT 0
+#endif
+
+namespace RealtimeAudit
+{
+    struct Report
+    {
+        juce::uint64 allocations = 0;
+        juce::uint64 deallocations = 0;
+        juce::uint64 locks = 0;
+        juce::uint64 blocksAudited = 0;
+
+        bool isClean() const { return allocations == 0 && deallocations == 0 && locks == 0; }
+        juce::String toString() const;
+    };
+
+   #if SIMPLEMBCOMP_RT_AUDIT
+    Report getReport();
+    void resetReport();
+
+    /** Resizes an AudioBuffer inside a ScopedAudioThread on purpose and returns
+        whether the audit counted it. The counts are left as they were.
+    */
+    bool catchesAllocations();
+
+    /** Marks the current thread as the audio thread for the lifetime of this
+        object. Pass false for work done on behalf of a block that is already
+        counted, e.g. on a worker thread, so blocksAudited stays per block.
+    */
+    struct ScopedAudioThread
+    {
+        explicit ScopedAudioThread (bool countsAsBlock = true);
+        ~ScopedAudioThread();
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedAudioThread)
+    };
+   #else
+    inline Report getReport() { return {}; }
+    inline void resetReport() {}
+    inline bool catchesAllocations() { return false; }
+
+    struct ScopedAudioThread
+    {
+        explicit ScopedAudioThread (bool = true) {}
+    };
+   #endif
+}
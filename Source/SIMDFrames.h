@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    SIMDFrames.h
+    Created: 17 Oct 2026 5:20:01am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Moves up to Vec::size() planar channels in and out of a buffer of
+    sample frames laid out as one SIMD register per frame. A recurrence that
+    runs the channels in lanes then loads and stores each frame as a whole
+    register, instead of gathering and scattering it a lane at a time.
+
+    The frame buffer has to be SIMD aligned. Lanes without a channel are
+    filled with zeros, so they never carry denormals or stale samples.
+*/
+namespace SIMDFrames
+{
+    // The channel count is a template parameter so the compiler can turn
+    // the frame loops into register shuffles; with a runtime count they
+    // stay scalar.
+    template <size_t NumChannels, typename SampleType>
+    void interleave (const SampleType* const* channels, size_t start, size_t numFrames, SampleType* frames) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<SampleType>::size();
+        static_assert(NumChannels <= numLanes, "More channels than lanes");
+
+        const SampleType* source[NumChannels];
+        for (size_t lane = 0; lane < NumChannels; ++lane)
+            source[lane] = channels[lane] + start;
+
+        for (size_t i = 0; i < numFrames; ++i)
+            for (size_t lane = 0; lane < numLanes; ++lane)
+                frames[i * numLanes + lane] = lane < NumChannels ? source[lane][i] : SampleType(0);
+    }
+
+    template <size_t NumChannels, typename SampleType>
+    void deinterleave (const SampleType* frames, size_t numFrames, SampleType* const* channels, size_t start) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<SampleType>::size();
+        static_assert(NumChannels <= numLanes, "More channels than lanes");
+
+        SampleType* dest[NumChannels];
+        for (size_t lane = 0; lane < NumChannels; ++lane)
+            dest[lane] = channels[lane] + start;
+
+        for (size_t i = 0; i < numFrames; ++i)
+            for (size_t lane = 0; lane < NumChannels; ++lane)
+                dest[lane][i] = frames[i * numLanes + lane];
+    }
+
+    // Calls fn(std::integral_constant<size_t, numChannels>) for numChannels in 1 .. Vec::size().
+    template <typename SampleType, typename Fn, size_t... Counts>
+    void withChannelCount (size_t numChannels, Fn&& fn, std::index_sequence<Counts...>) noexcept
+    {
+        ((numChannels == Counts + 1 ? fn(std::integral_constant<size_t, Counts + 1>{}) : void()), ...);
+    }
+
+    template <typename SampleType>
+    void interleave (const SampleType* const* channels, size_t numChannels, size_t start,
+                     size_t numFrames, SampleType* frames) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<SampleType>::size();
+        jassert(numChannels > 0 && numChannels <= numLanes);
+
+        withChannelCount<SampleType>(numChannels, [&] (auto count)
+        {
+            interleave<decltype(count)::value>(channels, start, numFrames, frames);
+        }, std::make_index_sequence<numLanes>{});
+    }
+
+    template <typename SampleType>
+    void deinterleave (const SampleType* frames, size_t numFrames, SampleType* const* channels,
+                       size_t numChannels, size_t start) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<SampleType>::size();
+        jassert(numChannels > 0 && numChannels <= numLanes);
+
+        withChannelCount<SampleType>(numChannels, [&] (auto count)
+        {
+            deinterleave<decltype(count)::value>(frames, numFrames, channels, start);
+        }, std::make_index_sequence<numLanes>{});
+    }
+}
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    SnapshotMorph.h
+    Created: 17 Oct 2026 4:30:34am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Moves every parameter of a processor to a new set of normalised values
+    over a short time, so switching presets neither jumps nor floods the
+    host with automation.
+
+    The parameters themselves never move on the audio thread. The message
+    thread publishes a snapshot into a single staging slot; the audio thread
+    takes it at the start of a block and from then on interpolates a private
+    copy of the normalised values, which the DSP reads through a
+    ParameterReader instead of the parameters. Continuous parameters glide
+    in a straight line of normalised value; choices and switches flip half
+    way through. Once the morph is done, the message thread sets the
+    parameters to the snapshot and calls release(), after which the DSP
+    reads the parameters again; they hold the same values by then.
+
+    Nothing here allocates after prepare().
+*/
+class SnapshotMorph
+{
+public:
+    /** Message thread, before processing starts. parametersToMorph has to be
+        every parameter of the processor, in getParameters() order.
+    */
+    void prepare (const juce::Array<juce::AudioProcessorParameter*>& parametersToMorph)
+    {
+        parameters.clear();
+        discrete.clear();
+
+        for (auto* param : parametersToMorph)
+        {
+            jassert(param->getParameterIndex() == static_cast<int>(parameters.size()));
+
+            parameters.push_back(param);
+            discrete.push_back(param->isDiscrete() || param->isBoolean() ? 1 : 0);
+        }
+
+        staging.assign(parameters.size(), 0.f);
+        from.assign(parameters.size(), 0.f);
+        to.assign(parameters.size(), 0.f);
+        values.assign(parameters.size(), 0.f);
+    }
+
+    /** Set from prepareToPlay, while the audio thread isn't running. */
+    void setLengthInSamples (int numSamples) noexcept
+    {
+        lengthInSamples = juce::jmax(1, numSamples);
+    }
+
+    /** Message thread. Replaces any snapshot the audio thread hasn't taken
+        yet, and returns a number that hasFinished() recognises it by.
+    */
+    int publish (const std::vector<float>& snapshot)
+    {
+        jassert(snapshot.size() == staging.size());
+
+        // The slot is only ever busy on the audio side for the length of a copy.
+        for (;;)
+        {
+            int expected = slotFree;
+            if (slotState.compare_exchange_weak(expected, slotWriting, std::memory_order_acquire))
+                break;
+
+            expected = slotReady;
+            if (slotState.compare_exchange_weak(expected, slotWriting, std::memory_order_acquire))
+                break;
+
+            std::this_thread::yield();
+        }
+
+        std::copy(snapshot.begin(), snapshot.end(), staging.begin());
+        stagingGeneration = ++lastGeneration;
+        slotState.store(slotReady, std::memory_order_release);
+
+        return lastGeneration;
+    }
+
+    /** Message thread. Withdraws the published snapshot if the audio thread
+        hasn't taken it, e.g. because nothing is being processed.
+    */
+    bool cancel() noexcept
+    {
+        int expected = slotReady;
+        return slotState.compare_exchange_strong(expected, slotFree, std::memory_order_acq_rel);
+    }
+
+    bool isPending() const noexcept
+    {
+        return slotState.load(std::memory_order_acquire) == slotReady;
+    }
+
+    /** Message thread. True once the audio thread has reached the end of the
+        snapshot publish() returned this number for.
+    */
+    bool hasFinished (int generation) const noexcept
+    {
+        return generation != 0 && finishedGeneration.load(std::memory_order_acquire) == generation;
+    }
+
+    /** Message thread, once the parameters hold what the DSP should read:
+        the audio thread goes back to reading the parameters from its next
+        block, and drops a morph that is still running.
+    */
+    void release() noexcept
+    {
+        released.store(true, std::memory_order_release);
+    }
+
+    /** Audio thread, once per block before the parameters are read. Returns
+        true if the morphed values moved, in which case the caller has to
+        make the DSP re-read them.
+    */
+    bool advance (int numSamples) noexcept
+    {
+        if (released.exchange(false, std::memory_order_acquire))
+        {
+            isOverriding = false;
+            isMorphing = false;
+        }
+
+        int expected = slotReady;
+        if (slotState.compare_exchange_strong(expected, slotReading, std::memory_order_acquire))
+        {
+            std::copy(staging.begin(), staging.end(), to.begin());
+            generation = stagingGeneration;
+            slotState.store(slotFree, std::memory_order_release);
+
+            // Anything released before this snapshot was published belongs to an older one.
+            released.store(false, std::memory_order_relaxed);
+
+            // A new snapshot during a morph starts from wherever that one had got to.
+            for (size_t i = 0; i < parameters.size(); ++i)
+                from[i] = isOverriding ? values[i] : parameters[i]->getValue();
+
+            values = from;
+            position = 0.0;
+            isMorphing = true;
+            isOverriding = true;
+        }
+
+        if ( ! isMorphing )
+            return false;
+
+        position = juce::jmin(1.0, position + static_cast<double>(numSamples) / lengthInSamples);
+        const auto t = static_cast<float>(position);
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            if (from[i] != to[i])
+                values[i] = discrete[i] != 0 ? (t < 0.5f ? from[i] : to[i])
+                                             : from[i] + (to[i] - from[i]) * t;
+        }
+
+        if (position >= 1.0)
+        {
+            isMorphing = false;
+            finishedGeneration.store(generation, std::memory_order_release);
+        }
+
+        return true;
+    }
+
+    /** Audio thread. True from taking a snapshot until after release(). */
+    bool isActive() const noexcept
+    {
+        return isOverriding;
+    }
+
+    /** Audio thread, while isActive(): the normalised value the DSP should use for param. */
+    float getValue (const juce::AudioProcessorParameter& param) const noexcept
+    {
+        jassert(isOverriding);
+        return values[static_cast<size_t>(param.getParameterIndex())];
+    }
+
+private:
+    enum SlotState { slotFree, slotWriting, slotReady, slotReading };
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    std::vector<char> discrete;
+
+    std::vector<float> staging;
+    int stagingGeneration = 0;
+    std::atomic<int> slotState { slotFree };
+
+    // Message thread only.
+    int lastGeneration = 0;
+
+    // Audio thread only.
+    std::vector<float> from, to, values;
+    double position = 0.0;
+    int lengthInSamples = 2048;
+    int generation = 0;
+    bool isMorphing = false, isOverriding = false;
+
+    std::atomic<int> finishedGeneration { 0 };
+    std::atomic<bool> released { false };
+};
+
+/*
+    How the DSP reads its parameters on the audio thread: from the morph's
+    values while one is active, otherwise from the parameters themselves.
+    A default constructed reader always reads the parameters, which is also
+    what the message thread has to use.
+*/
+struct ParameterReader
+{
+    const SnapshotMorph* morph = nullptr;
+
+    float operator() (const juce::AudioParameterFloat& param) const noexcept
+    {
+        return isMorphed() ? denormalise(param) : param.get();
+    }
+
+    int operator() (const juce::AudioParameterChoice& param) const noexcept
+    {
+        return isMorphed() ? juce::roundToInt(denormalise(param)) : param.getIndex();
+    }
+
+    bool operator() (const juce::AudioParameterBool& param) const noexcept
+    {
+        return isMorphed() ? morph->getValue(param) >= 0.5f : param.get();
+    }
+
+private:
+    bool isMorphed() const noexcept
+    {
+        return morph != nullptr && morph->isActive();
+    }
+
+    // Choice hides the base class's conversion behind its own private one.
+    float denormalise (const juce::RangedAudioParameter& param) const noexcept
+    {
+        return param.convertFrom0to1(morph->getValue(param));
+    }
+};
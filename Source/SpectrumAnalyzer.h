@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyzer.h
+    Created: 17 Oct 2026 4:38:58am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+    Single producer, single consumer ring of mono samples for the spectrum
+    analyzer. The audio thread pushes the average of a block's channels
+    straight into the ring; when the reader has fallen behind, whatever
+    doesn't fit is dropped. The storage is allocated on construction.
+*/
+class AnalyzerFifo
+{
+public:
+    static constexpr int capacity = 1 << 15;
+
+    AnalyzerFifo() : samples(static_cast<size_t>(capacity), 0.f) {}
+
+    template <typename SampleType>
+    void push (const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+    {
+        const auto numChannels = block.getNumChannels();
+        if (numChannels == 0)
+            return;
+
+        const auto scope = fifo.write(static_cast<int>(block.getNumSamples()));
+        const auto scale = SampleType(1) / static_cast<SampleType>(numChannels);
+
+        downmix(block, 0, samples.data() + scope.startIndex1, scope.blockSize1, scale);
+        downmix(block, static_cast<size_t>(scope.blockSize1), samples.data() + scope.startIndex2, scope.blockSize2, scale);
+    }
+
+    /** Reader thread. Returns the number of samples copied. */
+    int pull (float* dest, int maxSamples) noexcept
+    {
+        const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+        std::copy_n(samples.data() + scope.startIndex1, scope.blockSize1, dest);
+        std::copy_n(samples.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+private:
+    template <typename SampleType>
+    static void downmix (const juce::dsp::AudioBlock<const SampleType>& block, size_t start, float* dest, int numSamples, SampleType scale) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        const auto* first = block.getChannelPointer(0) + start;
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = static_cast<float>(first[i]);
+
+        for (size_t ch = 1; ch < block.getNumChannels(); ++ch)
+        {
+            const auto* data = block.getChannelPointer(ch) + start;
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] += static_cast<float>(data[i]);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] *= static_cast<float>(scale);
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    std::vector<float> samples;
+};
+
+/*
+    Turns the samples from a set of AnalyzerFifos into one spectrum path
+    each, on its own thread at a fixed rate: a Hann-windowed FFT over the
+    latest fftSize samples, levels that rise at once and fall at a fixed
+    rate, and a path over 20 Hz to 20 kHz on a log scale in whatever bounds
+    the display last set. The display only copies the finished paths.
+
+    Owned by the editor, so nothing runs while no editor is open.
+*/
+class SpectrumAnalyzer : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int frameRateHz = 30;
+
+    static constexpr float minFrequency = 20.f, maxFrequency = 20000.f;
+    static constexpr float minDecibels = -90.f, maxDecibels = 6.f;
+    static constexpr float fallDecibelsPerSecond = 60.f;
+
+    /** sampleRateSource is called from the analyzer thread once per frame. */
+    SpectrumAnalyzer (std::vector<AnalyzerFifo*> sourcesToAnalyze, std::function<double()> sampleRateSource)
+        : juce::Thread("Spectrum analyzer"),
+          getSampleRate(std::move(sampleRateSource)),
+          fft(fftOrder),
+          window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, true)
+    {
+        for (auto* source : sourcesToAnalyze)
+        {
+            auto trace = std::make_unique<Trace>();
+            trace->source = source;
+            traces.push_back(std::move(trace));
+        }
+
+        fftData.resize(static_cast<size_t>(fftSize) * 2);
+        incoming.resize(AnalyzerFifo::capacity);
+
+        startThread();
+    }
+
+    ~SpectrumAnalyzer() override
+    {
+        stopThread(1000);
+    }
+
+    /** Message thread. Where the paths are drawn, in the display's coordinates. */
+    void setBounds (juce::Rectangle<float> newBounds)
+    {
+        const juce::ScopedLock sl(pathLock);
+        bounds = newBounds;
+    }
+
+    /** Message thread. Copies the latest path of every source, in the order
+        they were given. False if nothing changed since the last call.
+    */
+    bool getPaths (std::vector<juce::Path>& dest)
+    {
+        const juce::ScopedLock sl(pathLock);
+        if (! pathsChanged)
+            return false;
+
+        dest.resize(traces.size());
+        for (size_t i = 0; i < traces.size(); ++i)
+            dest[i] = traces[i]->path;
+
+        pathsChanged = false;
+        return true;
+    }
+
+    static float frequencyToX (float frequency, juce::Rectangle<float> area) noexcept
+    {
+        return area.getX() + area.getWidth() * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+    }
+
+    static float decibelsToY (float decibels, juce::Rectangle<float> area) noexcept
+    {
+        return juce::jmap(juce::jlimit(minDecibels, maxDecibels, decibels), minDecibels, maxDecibels, area.getBottom(), area.getY());
+    }
+
+private:
+    struct Trace
+    {
+        AnalyzerFifo* source = nullptr;
+        std::vector<float> history = std::vector<float>(static_cast<size_t>(fftSize), 0.f);
+        size_t writePosition = 0;
+        std::vector<float> levels = std::vector<float>(static_cast<size_t>(fftSize / 2 + 1), minDecibels);
+        juce::Path path, nextPath;
+    };
+
+    void run() override
+    {
+        const auto frameMs = 1000.0 / frameRateHz;
+        auto nextFrame = juce::Time::getMillisecondCounterHiRes();
+
+        while (! threadShouldExit())
+        {
+            const auto sampleRate = getSampleRate();
+            juce::Rectangle<float> area;
+            {
+                const juce::ScopedLock sl(pathLock);
+                area = bounds;
+            }
+
+            for (auto& trace : traces)
+            {
+                readSamples(*trace);
+                analyze(*trace);
+                buildPath(*trace, sampleRate, area);
+            }
+
+            {
+                const juce::ScopedLock sl(pathLock);
+                for (auto& trace : traces)
+                    trace->path.swapWithPath(trace->nextPath);
+                pathsChanged = true;
+            }
+
+            nextFrame += frameMs;
+            const auto now = juce::Time::getMillisecondCounterHiRes();
+            if (nextFrame < now)
+                nextFrame = now;
+
+            wait(static_cast<int>(nextFrame - now));
+        }
+    }
+
+    void readSamples (Trace& trace)
+    {
+        const auto numRead = trace.source->pull(incoming.data(), static_cast<int>(incoming.size()));
+        const auto size = trace.history.size();
+
+        // Only the last fftSize samples matter.
+        const auto skip = static_cast<size_t>(juce::jmax(0, numRead - fftSize));
+        for (auto i = skip; i < static_cast<size_t>(numRead); ++i)
+        {
+            trace.history[trace.writePosition] = incoming[i];
+            trace.writePosition = (trace.writePosition + 1) % size;
+        }
+    }
+
+    void analyze (Trace& trace)
+    {
+        // Oldest sample first.
+        const auto size = trace.history.size();
+        std::copy(trace.history.begin() + static_cast<std::ptrdiff_t>(trace.writePosition), trace.history.end(), fftData.begin());
+        std::copy(trace.history.begin(), trace.history.begin() + static_cast<std::ptrdiff_t>(trace.writePosition),
+                  fftData.begin() + static_cast<std::ptrdiff_t>(size - trace.writePosition));
+        std::fill(fftData.begin() + fftSize, fftData.end(), 0.f);
+
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        // A full scale sine reads 0 dB.
+        const auto scale = 2.f / fftSize;
+        const auto fall = fallDecibelsPerSecond / frameRateHz;
+
+        for (size_t bin = 0; bin < trace.levels.size(); ++bin)
+        {
+            const auto level = juce::Decibels::gainToDecibels(fftData[bin] * scale, minDecibels);
+            trace.levels[bin] = juce::jmax(level, trace.levels[bin] - fall);
+        }
+    }
+
+    void buildPath (Trace& trace, double sampleRate, juce::Rectangle<float> area)
+    {
+        auto& path = trace.nextPath;
+        path.clear();
+
+        if (area.isEmpty() || sampleRate <= 0.0)
+            return;
+
+        const auto binsPerHz = fftSize / static_cast<float>(sampleRate);
+        const auto lastBin = trace.levels.size() - 1;
+        const auto numPoints = juce::jmax(2, static_cast<int>(area.getWidth()));
+
+        // Each point shows the loudest bin between it and the next, so narrow
+        // peaks at the top of the range aren't skipped over.
+        for (int point = 0; point < numPoints; ++point)
+        {
+            const auto x = area.getX() + area.getWidth() * point / (numPoints - 1);
+            const auto frequency = minFrequency * std::pow(maxFrequency / minFrequency, static_cast<float>(point) / (numPoints - 1));
+            const auto nextFrequency = minFrequency * std::pow(maxFrequency / minFrequency, static_cast<float>(point + 1) / (numPoints - 1));
+
+            const auto firstBin = juce::jmin(lastBin, static_cast<size_t>(frequency * binsPerHz));
+            const auto endBin = juce::jmin(lastBin, juce::jmax(firstBin, static_cast<size_t>(nextFrequency * binsPerHz)));
+
+            auto level = minDecibels;
+            for (auto bin = firstBin; bin <= endBin; ++bin)
+                level = juce::jmax(level, trace.levels[bin]);
+
+            const auto y = decibelsToY(level, area);
+            if (point == 0)
+                path.startNewSubPath(x, y);
+            else
+                path.lineTo(x, y);
+        }
+    }
+
+    std::function<double()> getSampleRate;
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> fftData, incoming;
+
+    std::vector<std::unique_ptr<Trace>> traces;
+
+    juce::CriticalSection pathLock;
+    juce::Rectangle<float> bounds;
+    bool pathsChanged = false;
+
+    JUCE_DECLARE_NON_COPYABLE (SpectrumAnalyzer)
+};
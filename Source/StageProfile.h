@@ -0,0 +1,328 @@
+/*
+  ==============================================================================
+
+    StageProfile.h
+    Created: 17 Oct 2026 4:34:07am
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+/*
+    Per-stage timing of processBlock.
+
+    Build with SIMPLEMBCOMP_PROFILE=1 (the "Profile" configurations in the
+    .jucers do this) and every stage of the signal path is timed with the
+    CPU's cycle counter. A stage's time is summed over the host block and
+    goes into that stage's histogram once per block, so the percentiles are
+    per block rather than per call.
+
+    Each histogram only ever has one writer at a time (the audio thread, or
+    the worker running that band), so recording is a handful of relaxed
+    atomic loads and stores, with no locks or read-modify-write operations.
+    Any other thread can read the percentiles while audio is running.
+    In a normal build all of this compiles away to nothing.
+*/
+#ifndef SIMPLEMBCOMP_PROFILE
+ #define SIMPLEMBCOMP_PROFILE 0
+#endif
+
+namespace Profiling
+{
+    /** The signal path's stages; the band compressors follow firstBand. */
+    enum Stage
+    {
+        wholeBlock,
+        inputGain,
+        crossover,
+        summation,
+        outputGain,
+        firstBand
+    };
+
+    struct StageStats
+    {
+        juce::uint64 numBlocks = 0;
+        double p50Micros = 0.0, p99Micros = 0.0, maxMicros = 0.0;
+    };
+
+   #if SIMPLEMBCOMP_PROFILE
+    /** A raw timestamp: the time stamp counter on x86, the virtual counter on
+        64-bit ARM, the high resolution timer elsewhere.
+    */
+    inline juce::uint64 readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::uint64>(__rdtsc());
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        juce::uint64 value;
+        asm volatile ("mrs %0, cntvct_el0" : "=r" (value));
+        return value;
+       #else
+        return static_cast<juce::uint64>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+
+    /** Counter ticks per second. Measured once on x86, which takes about 50 ms,
+        so call it from a reader thread rather than the audio thread.
+    */
+    inline double getCyclesPerSecond()
+    {
+        static const double cyclesPerSecond = []
+        {
+           #if JUCE_INTEL
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            const auto startCycles = readCycleCounter();
+            juce::Thread::sleep(50);
+            const auto cycles = static_cast<double>(readCycleCounter() - startCycles);
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            return cycles / seconds;
+           #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+            juce::uint64 frequency;
+            asm volatile ("mrs %0, cntfrq_el0" : "=r" (frequency));
+            return static_cast<double>(frequency);
+           #else
+            return static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+           #endif
+        }();
+
+        return cyclesPerSecond;
+    }
+
+    /*
+        Log-linear histogram of cycle counts: exact below 16, then eight bins
+        per octave, so any percentile is within 12.5% of the true value.
+    */
+    class Histogram
+    {
+    public:
+        static constexpr int numBins = 16 + 60 * 8;
+
+        /** Only one thread may call this at a time. */
+        void record (juce::uint64 cycles) noexcept
+        {
+            auto& bin = bins[static_cast<size_t>(getBin(cycles))];
+            bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (cycles > maximum.load(std::memory_order_relaxed))
+                maximum.store(cycles, std::memory_order_relaxed);
+        }
+
+        /** Not while anything is recording. */
+        void reset() noexcept
+        {
+            for (auto& bin : bins)
+                bin.store(0, std::memory_order_relaxed);
+
+            total.store(0, std::memory_order_relaxed);
+            maximum.store(0, std::memory_order_relaxed);
+        }
+
+        /** In cycles: the middle of the bin holding the given fraction of the
+            values, but never more than the largest value recorded.
+        */
+        double getPercentile (double fraction) const noexcept
+        {
+            std::array<juce::uint32, numBins> counts;
+            juce::uint64 count = 0;
+
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i] = bins[i].load(std::memory_order_relaxed);
+                count += counts[i];
+            }
+
+            if (count == 0)
+                return 0.0;
+
+            const auto rank = static_cast<juce::uint64>(std::ceil(fraction * static_cast<double>(count)));
+            juce::uint64 seen = 0;
+
+            for (int i = 0; i < numBins; ++i)
+            {
+                seen += counts[static_cast<size_t>(i)];
+                if (seen < juce::jmax<juce::uint64>(rank, 1))
+                    continue;
+
+                const auto middle = i < 16 ? static_cast<double>(i)
+                                           : 0.5 * (static_cast<double>(getBinStart(i)) + static_cast<double>(getBinStart(i + 1)));
+                return juce::jmin(middle, static_cast<double>(getMaximum()));
+            }
+
+            return static_cast<double>(getMaximum());
+        }
+
+        juce::uint64 getCount() const noexcept { return total.load(std::memory_order_relaxed); }
+        juce::uint64 getMaximum() const noexcept { return maximum.load(std::memory_order_relaxed); }
+
+    private:
+        static int getBin (juce::uint64 cycles) noexcept
+        {
+            if (cycles < 16)
+                return static_cast<int>(cycles);
+
+            const auto octave = juce::jmin(63, highestBit(cycles));
+            const auto step = static_cast<int>((cycles >> (octave - 3)) & 7);
+            return juce::jmin(numBins - 1, 16 + (octave - 4) * 8 + step);
+        }
+
+        static juce::uint64 getBinStart (int bin) noexcept
+        {
+            if (bin < 16)
+                return static_cast<juce::uint64>(bin);
+
+            const auto octave = (bin - 16) / 8 + 4;
+            const auto step = static_cast<juce::uint64>((bin - 16) % 8);
+            return (8 + step) << (octave - 3);
+        }
+
+        static int highestBit (juce::uint64 value) noexcept
+        {
+            int bit = 0;
+            while (value >>= 1)
+                ++bit;
+            return bit;
+        }
+
+        std::array<std::atomic<juce::uint32>, numBins> bins {};
+        std::atomic<juce::uint64> total { 0 }, maximum { 0 };
+    };
+
+    /*
+        One histogram per stage, plus the time spent in each stage during the
+        current block. A stage's pending time is only touched by the thread
+        running that stage, and endBlock() runs on the audio thread after the
+        band workers have been joined.
+    */
+    template <size_t NumBands>
+    class StageProfile
+    {
+    public:
+        static constexpr int numStages = firstBand + static_cast<int>(NumBands);
+
+        static juce::String getStageName (int stage)
+        {
+            switch (stage)
+            {
+                case wholeBlock: return "block";
+                case inputGain:  return "input gain";
+                case crossover:  return "crossover";
+                case summation:  return "summation";
+                case outputGain: return "output gain";
+                default:         return "band " + juce::String(stage - firstBand + 1);
+            }
+        }
+
+        /** Times its own lifetime and adds it to the stage's time for this block. */
+        class ScopedStage
+        {
+        public:
+            ScopedStage (StageProfile* profileToUse, int stageToTime) noexcept
+                : profile(profileToUse), stage(stageToTime), start(profile != nullptr ? readCycleCounter() : 0)
+            {
+            }
+
+            ~ScopedStage()
+            {
+                if (profile != nullptr)
+                    profile->pending[static_cast<size_t>(stage)] += readCycleCounter() - start;
+            }
+
+        private:
+            StageProfile* profile;
+            int stage;
+            juce::uint64 start;
+
+            JUCE_DECLARE_NON_COPYABLE (ScopedStage)
+        };
+
+        /** Audio thread, at the end of a host block. Stages that didn't run aren't recorded. */
+        void endBlock() noexcept
+        {
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                if (pending[i] > 0)
+                    histograms[i].record(pending[i]);
+
+                pending[i] = 0;
+            }
+        }
+
+        /** While the audio thread isn't running, e.g. from prepareToPlay. */
+        void reset() noexcept
+        {
+            for (auto& histogram : histograms)
+                histogram.reset();
+
+            pending.fill(0);
+        }
+
+        /** Any thread. */
+        StageStats getStats (int stage) const
+        {
+            jassert(juce::isPositiveAndBelow(stage, numStages));
+
+            const auto& histogram = histograms[static_cast<size_t>(stage)];
+            const auto microsPerCycle = 1.0e6 / getCyclesPerSecond();
+
+            StageStats stats;
+            stats.numBlocks = histogram.getCount();
+            stats.p50Micros = histogram.getPercentile(0.5) * microsPerCycle;
+            stats.p99Micros = histogram.getPercentile(0.99) * microsPerCycle;
+            stats.maxMicros = static_cast<double>(histogram.getMaximum()) * microsPerCycle;
+            return stats;
+        }
+
+        juce::String toString() const
+        {
+            juce::String s;
+            s << "stage,blocks,p50_us,p99_us,max_us\n";
+
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                const auto stats = getStats(stage);
+                s << getStageName(stage) << "," << juce::String(static_cast<juce::int64>(stats.numBlocks)) << ","
+                  << juce::String(stats.p50Micros, 3) << "," << juce::String(stats.p99Micros, 3) << ","
+                  << juce::String(stats.maxMicros, 3) << "\n";
+            }
+
+            return s;
+        }
+
+    private:
+        std::array<Histogram, static_cast<size_t>(numStages)> histograms;
+        std::array<juce::uint64, static_cast<size_t>(numStages)> pending {};
+    };
+   #else
+    template <size_t NumBands>
+    class StageProfile
+    {
+    public:
+        static constexpr int numStages = firstBand + static_cast<int>(NumBands);
+
+        static juce::String getStageName (int) { return {}; }
+
+        struct ScopedStage
+        {
+            ScopedStage (StageProfile*, int) noexcept {}
+        };
+
+        void endBlock() noexcept {}
+        void reset() noexcept {}
+        StageStats getStats (int) const { return {}; }
+        juce::String toString() const { return {}; }
+    };
+   #endif
+}
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    BaselineProcessor.h
+    Created: 17 Oct 2026 4:57:26am
+    Author:  agent
+
+    The signal path of the original three band plugin, on the same
+    juce::dsp filters, compressors and gains and in the same order, so the
+    golden files can be rendered from it rather than from the code they are
+    there to check. Keep it as it is: it is the reference, not a
+    processor to improve.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+namespace Golden
+{
+    /** Everything the original plugin had a parameter for, at its defaults. */
+    struct BaselineSettings
+    {
+        struct Band
+        {
+            float attack = 50.f, release = 250.f, threshold = 0.f;
+            // One of the original ratio choices.
+            float ratio = 3.f;
+            bool bypassed = false, mute = false, solo = false;
+        };
+
+        float lowMidCrossover = 500.f, midHighCrossover = 3000.f;
+        float inputGain = 0.f, outputGain = 0.f;
+        std::array<Band, 3> bands;
+    };
+
+    class BaselineProcessor
+    {
+    public:
+        explicit BaselineProcessor (const BaselineSettings& settingsToUse)
+            : settings(settingsToUse)
+        {
+            LP0.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+            HP0.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+
+            AP1.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+
+            LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+            HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+        }
+
+        void prepare (double sampleRate, int samplesPerBlock, int numChannels)
+        {
+            juce::dsp::ProcessSpec spec;
+            spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
+            spec.numChannels = static_cast<juce::uint32>(numChannels);
+            spec.sampleRate = sampleRate;
+
+            for (auto& compressor : compressors)
+            {
+                compressor.prepare(spec);
+            }
+
+            inputGain.prepare(spec);
+            outputGain.prepare(spec);
+            inputGain.setRampDurationSeconds(0.05);
+            outputGain.setRampDurationSeconds(0.05);
+
+            LP0.prepare(spec);
+            HP0.prepare(spec);
+
+            AP1.prepare(spec);
+
+            LP1.prepare(spec);
+            HP1.prepare(spec);
+
+            for (auto& buffer : filterBuffers)
+            {
+                buffer.setSize(numChannels, samplesPerBlock);
+            }
+        }
+
+        void process (juce::AudioBuffer<float>& buffer)
+        {
+            juce::ScopedNoDenormals noDenormals;
+
+            for (size_t i = 0; i < compressors.size(); ++i)
+            {
+                const auto& band = settings.bands[i];
+                compressors[i].setAttack(band.attack);
+                compressors[i].setRelease(band.release);
+                compressors[i].setThreshold(band.threshold);
+                compressors[i].setRatio(band.ratio);
+            }
+
+            inputGain.setGainDecibels(settings.inputGain);
+            outputGain.setGainDecibels(settings.outputGain);
+
+            applyGain(buffer, inputGain);
+
+            for (auto& filterBuffer : filterBuffers)
+            {
+                filterBuffer = buffer;
+            }
+
+            LP0.setCutoffFrequency(settings.lowMidCrossover);
+            HP0.setCutoffFrequency(settings.lowMidCrossover);
+
+            AP1.setCutoffFrequency(settings.midHighCrossover);
+            LP1.setCutoffFrequency(settings.midHighCrossover);
+            HP1.setCutoffFrequency(settings.midHighCrossover);
+
+            auto fb0Block = juce::dsp::AudioBlock<float>(filterBuffers[0]);
+            auto fb1Block = juce::dsp::AudioBlock<float>(filterBuffers[1]);
+            auto fb2Block = juce::dsp::AudioBlock<float>(filterBuffers[2]);
+
+            auto fb0Context = juce::dsp::ProcessContextReplacing<float>(fb0Block);
+            auto fb1Context = juce::dsp::ProcessContextReplacing<float>(fb1Block);
+            auto fb2Context = juce::dsp::ProcessContextReplacing<float>(fb2Block);
+
+            LP0.process(fb0Context);
+            AP1.process(fb0Context);
+
+            HP0.process(fb1Context);
+            filterBuffers[2] = filterBuffers[1];
+
+            LP1.process(fb1Context);
+            HP1.process(fb2Context);
+
+            for (size_t i = 0; i < filterBuffers.size(); ++i)
+            {
+                auto block = juce::dsp::AudioBlock<float>(filterBuffers[i]);
+                auto context = juce::dsp::ProcessContextReplacing<float>(block);
+                context.isBypassed = settings.bands[i].bypassed;
+                compressors[i].process(context);
+            }
+
+            const auto numSamples = buffer.getNumSamples();
+            const auto numChannels = buffer.getNumChannels();
+
+            buffer.clear();
+
+            auto bandsAreSoloed = false;
+            for (auto& band : settings.bands)
+            {
+                bandsAreSoloed = bandsAreSoloed || band.solo;
+            }
+
+            for (size_t i = 0; i < filterBuffers.size(); ++i)
+            {
+                const auto& band = settings.bands[i];
+                if (bandsAreSoloed ? ! band.solo : band.mute)
+                    continue;
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    buffer.addFrom(ch, 0, filterBuffers[i], ch, 0, numSamples);
+                }
+            }
+
+            applyGain(buffer, outputGain);
+        }
+
+    private:
+        static void applyGain (juce::AudioBuffer<float>& buffer, juce::dsp::Gain<float>& gain)
+        {
+            auto block = juce::dsp::AudioBlock<float>(buffer);
+            auto context = juce::dsp::ProcessContextReplacing<float>(block);
+            gain.process(context);
+        }
+
+        BaselineSettings settings;
+
+        std::array<juce::dsp::Compressor<float>, 3> compressors;
+
+        using Filter = juce::dsp::LinkwitzRileyFilter<float>;
+        //      FC0     FC1
+        Filter  LP0,    AP1,
+                HP0,    LP1,
+                        HP1;
+
+        std::array<juce::AudioBuffer<float>, 3> filterBuffers;
+
+        juce::dsp::Gain<float> inputGain, outputGain;
+    };
+}
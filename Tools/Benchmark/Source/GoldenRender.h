@@ -0,0 +1,654 @@
+/*
+  ==============================================================================
+
+    GoldenRender.h
+    Created: 17 Oct 2026 4:35:57am
+    Author:  agent
+
+    Golden-render checks: renders fixed test signals through the processor
+    and compares them with renders of the original plugin's signal path
+    (BaselineProcessor), stored in Tools/Benchmark/Golden, with paths that
+    must agree with each other, and with a flat crossover sum. Any rewrite
+    of the crossover or the compressors has to pass these before it ships.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "BaselineProcessor.h"
+
+namespace Golden
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+
+    //==============================================================================
+    /** xorshift32, so the noise in the test signals doesn't depend on the JUCE
+        version's juce::Random. Returns -1 to 1 in steps of 2^-23.
+    */
+    struct NoiseSource
+    {
+        juce::uint32 state;
+
+        float next() noexcept
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return static_cast<float>(state >> 8) * (1.f / 16777216.f) * 2.f - 1.f;
+        }
+    };
+
+    /** Deterministic test signals, all stereo at 48 kHz and below full scale.
+        Short, since every case keeps a 32-bit render of each in the repository.
+    */
+    struct TestSignal
+    {
+        juce::String name;
+        juce::AudioBuffer<float> audio;
+    };
+
+    inline juce::AudioBuffer<float> makeSweep()
+    {
+        // Exponential sine sweep, 20 Hz to 20 kHz in two seconds at -6 dBFS.
+        const auto duration = 2.0;
+        const auto length = static_cast<int>(duration * sampleRate);
+        const auto f0 = 20.0, f1 = 20000.0;
+        const auto k = std::log(f1 / f0);
+
+        juce::AudioBuffer<float> audio (numChannels, length);
+        for (int i = 0; i < length; ++i)
+        {
+            const auto t = i / sampleRate;
+            const auto phase = juce::MathConstants<double>::twoPi * f0 * duration / k * (std::exp(t * k / duration) - 1.0);
+            const auto value = static_cast<float>(0.5 * std::sin(phase));
+
+            audio.setSample(0, i, value);
+            audio.setSample(1, i, value);
+        }
+
+        return audio;
+    }
+
+    inline juce::AudioBuffer<float> makeImpulses()
+    {
+        // Four impulses a second, stepping down 6 dB each and the right channel
+        // a little later, so attack, release and linking all get exercised.
+        const auto length = static_cast<int>(2.0 * sampleRate);
+        const auto spacing = static_cast<int>(0.25 * sampleRate);
+
+        juce::AudioBuffer<float> audio (numChannels, length);
+        audio.clear();
+
+        auto amplitude = 1.f;
+        for (int pos = spacing / 2; pos + 7 < length; pos += spacing)
+        {
+            audio.setSample(0, pos, amplitude);
+            audio.setSample(1, pos + 7, -amplitude);
+            amplitude = amplitude < 0.01f ? 1.f : amplitude * 0.5f;
+        }
+
+        return audio;
+    }
+
+    inline juce::AudioBuffer<float> makePinkNoise()
+    {
+        // Paul Kellet's economy filter on seeded white noise, about -12 dBFS RMS.
+        const auto length = static_cast<int>(1.0 * sampleRate);
+        juce::AudioBuffer<float> audio (numChannels, length);
+        NoiseSource noise { 0x91a7 };
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float b0 = 0.f, b1 = 0.f, b2 = 0.f;
+            auto* data = audio.getWritePointer(ch);
+
+            for (int i = 0; i < length; ++i)
+            {
+                const auto white = noise.next();
+                b0 = 0.99765f * b0 + white * 0.0990460f;
+                b1 = 0.96300f * b1 + white * 0.2965164f;
+                b2 = 0.57000f * b2 + white * 1.0526913f;
+                data[i] = 0.1f * (b0 + b1 + b2 + white * 0.1848f);
+            }
+        }
+
+        return audio;
+    }
+
+    inline juce::AudioBuffer<float> makeProgram()
+    {
+        // Two seconds of a synthetic mix: a kick on every beat at 120 bpm,
+        // hats on the off beats, a bass line and a slow chord, panned apart.
+        const auto length = static_cast<int>(2.0 * sampleRate);
+        const auto beat = static_cast<int>(0.5 * sampleRate);
+        const auto twoPi = juce::MathConstants<double>::twoPi;
+
+        juce::AudioBuffer<float> audio (numChannels, length);
+        NoiseSource noise { 0x7e57 };
+        const double bassNotes[] { 55.0, 55.0, 73.42, 65.41 };
+        const double chord[] { 220.0, 277.18, 329.63, 415.3 };
+
+        for (int i = 0; i < length; ++i)
+        {
+            const auto t = i / sampleRate;
+            const auto inBeat = (i % beat) / sampleRate;
+            const auto offBeat = ((i + beat / 2) % beat) / sampleRate;
+
+            const auto kick = 0.8 * std::exp(-inBeat * 18.0) * std::sin(twoPi * (45.0 * inBeat + 60.0 * (1.0 - std::exp(-inBeat * 30.0)) / 30.0));
+            const auto hat = 0.15 * std::exp(-offBeat * 60.0) * noise.next();
+            const auto bass = 0.3 * std::sin(twoPi * bassNotes[(i / (beat * 2)) % 4] * t) * (0.6 + 0.4 * std::exp(-inBeat * 4.0));
+
+            auto pad = 0.0;
+            for (auto f : chord)
+                pad += 0.05 * std::sin(twoPi * f * t + f);
+            pad *= 0.5 + 0.5 * std::sin(twoPi * 0.25 * t);
+
+            audio.setSample(0, i, static_cast<float>(kick + bass + 0.7 * hat + 1.2 * pad));
+            audio.setSample(1, i, static_cast<float>(kick + bass + 1.3 * hat + 0.8 * pad));
+        }
+
+        return audio;
+    }
+
+    inline std::vector<TestSignal> makeTestSignals()
+    {
+        std::vector<TestSignal> signals;
+        signals.push_back({ "sweep", makeSweep() });
+        signals.push_back({ "impulses", makeImpulses() });
+        signals.push_back({ "pink", makePinkNoise() });
+        signals.push_back({ "program", makeProgram() });
+        return signals;
+    }
+
+    //==============================================================================
+    inline void setParameter (SimpleMBCompAudioProcessor& processor, const juce::String& name, float value)
+    {
+        auto* param = processor.apvts.getParameter(name);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    inline void setBandParameter (SimpleMBCompAudioProcessor& processor, Params::BandParam param, size_t band, float value)
+    {
+        setParameter(processor, Params::GetBandParamName<SimpleMBCompAudioProcessor::numBands>(param, band), value);
+    }
+
+    inline void setAllBands (SimpleMBCompAudioProcessor& processor, Params::BandParam param, float value)
+    {
+        for (size_t band = 0; band < SimpleMBCompAudioProcessor::numBands; ++band)
+            setBandParameter(processor, param, band, value);
+    }
+
+    using Setup = std::function<void (SimpleMBCompAudioProcessor&)>;
+
+    /** Sets the processor's parameters to the original plugin's settings and
+        leaves every parameter added since at its default. Three bands only.
+    */
+    inline void applySettings (SimpleMBCompAudioProcessor& processor, const BaselineSettings& settings)
+    {
+        using namespace Params;
+        constexpr auto numBands = SimpleMBCompAudioProcessor::numBands;
+        jassert(numBands == settings.bands.size());
+
+        setParameter(processor, GetCrossoverParamName<numBands>(0), settings.lowMidCrossover);
+        setParameter(processor, GetCrossoverParamName<numBands>(1), settings.midHighCrossover);
+        setParameter(processor, GetParams().at(Names::Gain_In), settings.inputGain);
+        setParameter(processor, GetParams().at(Names::Gain_Out), settings.outputGain);
+
+        for (size_t band = 0; band < settings.bands.size(); ++band)
+        {
+            const auto& b = settings.bands[band];
+            const auto ratioIndex = std::distance(RatioChoices.begin(), std::find(RatioChoices.begin(), RatioChoices.end(), b.ratio));
+            jassert(ratioIndex < static_cast<std::ptrdiff_t>(RatioChoices.size()));
+
+            setBandParameter(processor, BandParam::Attack, band, b.attack);
+            setBandParameter(processor, BandParam::Release, band, b.release);
+            setBandParameter(processor, BandParam::Threshold, band, b.threshold);
+            setBandParameter(processor, BandParam::Ratio, band, static_cast<float>(ratioIndex));
+            setBandParameter(processor, BandParam::Bypassed, band, b.bypassed ? 1.f : 0.f);
+            setBandParameter(processor, BandParam::Mute, band, b.mute ? 1.f : 0.f);
+            setBandParameter(processor, BandParam::Solo, band, b.solo ? 1.f : 0.f);
+        }
+    }
+
+    /** The part of the signal path a golden case is there to check. */
+    enum class Stage
+    {
+        crossover,
+        compressor
+    };
+
+    /** Largest allowed difference from the original, in dBFS. */
+    inline double getToleranceDecibels (Stage stage)
+    {
+        switch (stage)
+        {
+            // The swept crossover takes its coefficients from the table, which
+            // puts it about -118 dB from the filter tree (Stepped mode is bit exact).
+            case Stage::crossover:  return -110.0;
+            // The polynomial log2/exp2 gain math is within 0.00012 dB of std::pow.
+            case Stage::compressor: return -90.0;
+        }
+
+        return 0.0;
+    }
+
+    /** Settings the original plugin had, with a golden render per test signal. */
+    struct GoldenCase
+    {
+        juce::String name;
+        Stage stage;
+        BaselineSettings settings;
+    };
+
+    inline BaselineSettings compressHard()
+    {
+        BaselineSettings settings;
+        for (auto& band : settings.bands)
+        {
+            band.threshold = -30.f;
+            band.ratio = 3.f;
+        }
+
+        return settings;
+    }
+
+    inline std::vector<GoldenCase> getGoldenCases()
+    {
+        // The crossover alone: every band bypassed.
+        auto crossover = BaselineSettings();
+        for (auto& band : crossover.bands)
+            band.bypassed = true;
+
+        auto bandStates = compressHard();
+        bandStates.bands[0].bypassed = true;
+        bandStates.bands[2].mute = true;
+
+        return {
+            { "crossover", Stage::crossover, crossover },
+            { "compressed", Stage::compressor, compressHard() },
+            { "band-states", Stage::compressor, bandStates }
+        };
+    }
+
+    //==============================================================================
+    struct RenderOptions
+    {
+        int blockSize = 512;
+        bool useDouble = false;
+        bool referenceGainMath = false;
+    };
+
+    struct Render
+    {
+        juce::AudioBuffer<float> audio;
+        double secondsOfAudio = 0.0, wallSeconds = 0.0;
+
+        double getSpeed() const { return secondsOfAudio / juce::jmax(wallSeconds, 1.0e-9); }
+    };
+
+    /** Renders input through a new processor, with the latency removed so the output lines up with it. */
+    template <typename SampleType>
+    Render renderWith (const Setup& setup, const juce::AudioBuffer<float>& input, const RenderOptions& options)
+    {
+        SimpleMBCompAudioProcessor processor;
+        processor.setParallelBandMode(SimpleMBCompAudioProcessor::ParallelBandMode::Off);
+        processor.setUseReferenceGainMath(options.referenceGainMath);
+        processor.setProcessingPrecision(std::is_same<SampleType, double>::value ? juce::AudioProcessor::doublePrecision
+                                                                                  : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, options.blockSize);
+        setup(processor);
+
+        processor.setNonRealtime(true);
+        processor.prepareToPlay(sampleRate, options.blockSize);
+        processor.reset();
+
+        const auto length = input.getNumSamples();
+        const auto latency = processor.getLatencySamples();
+
+        juce::AudioBuffer<SampleType> buffer (numChannels, options.blockSize);
+        juce::MidiBuffer midi;
+
+        Render render;
+        render.audio.setSize(numChannels, length);
+        render.secondsOfAudio = length / sampleRate;
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        for (int pos = 0; pos < length + latency; pos += options.blockSize)
+        {
+            const auto numSamples = juce::jmin(options.blockSize, length + latency - pos);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < juce::jmin(numSamples, length - pos); ++i)
+                    buffer.setSample(ch, i, static_cast<SampleType>(input.getSample(ch, pos + i)));
+
+            processor.processBlock(buffer, midi);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto outPos = pos + i - latency;
+                    if (outPos >= 0 && outPos < length)
+                        render.audio.setSample(ch, outPos, static_cast<float>(buffer.getSample(ch, i)));
+                }
+            }
+        }
+
+        render.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        processor.releaseResources();
+        return render;
+    }
+
+    inline Render render (const Setup& setup, const juce::AudioBuffer<float>& input, const RenderOptions& options = {})
+    {
+        return options.useDouble ? renderWith<double>(setup, input, options)
+                                 : renderWith<float>(setup, input, options);
+    }
+
+    inline Render render (const BaselineSettings& settings, const juce::AudioBuffer<float>& input, const RenderOptions& options = {})
+    {
+        return render([&settings](auto& p) { applySettings(p, settings); }, input, options);
+    }
+
+    /** Renders input through the original plugin's signal path, in the same blocks as render(). */
+    inline juce::AudioBuffer<float> renderBaseline (const BaselineSettings& settings, const juce::AudioBuffer<float>& input,
+                                                    int blockSize = RenderOptions().blockSize)
+    {
+        BaselineProcessor processor (settings);
+        processor.prepare(sampleRate, blockSize, numChannels);
+
+        const auto length = input.getNumSamples();
+        juce::AudioBuffer<float> output (numChannels, length);
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+
+        for (int pos = 0; pos < length; pos += blockSize)
+        {
+            const auto numSamples = juce::jmin(blockSize, length - pos);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.copyFrom(ch, 0, input, ch, pos, numSamples);
+
+            processor.process(buffer);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                output.copyFrom(ch, pos, buffer, ch, 0, numSamples);
+        }
+
+        return output;
+    }
+
+    /** Peak and RMS of the difference, in dBFS. */
+    struct Difference
+    {
+        double peakDecibels = -400.0, rmsDecibels = -400.0;
+    };
+
+    inline Difference compare (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        jassert(a.getNumChannels() == b.getNumChannels() && a.getNumSamples() == b.getNumSamples());
+
+        double peak = 0.0, sumSquares = 0.0;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < a.getNumSamples(); ++i)
+            {
+                const auto error = static_cast<double>(a.getSample(ch, i)) - b.getSample(ch, i);
+                peak = juce::jmax(peak, std::abs(error));
+                sumSquares += error * error;
+            }
+        }
+
+        const auto count = juce::jmax(1, a.getNumChannels() * a.getNumSamples());
+        return { juce::Decibels::gainToDecibels(peak, -400.0),
+                 juce::Decibels::gainToDecibels(std::sqrt(sumSquares / count), -400.0) };
+    }
+
+    //==============================================================================
+    /** Golden files are 32-bit float WAVs, so they round-trip every sample exactly. */
+    inline bool writeGolden (const juce::File& file, const juce::AudioBuffer<float>& audio)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream (file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor(stream.get(), sampleRate,
+                                                                             static_cast<unsigned int>(audio.getNumChannels()),
+                                                                             32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+
+    inline bool readGolden (const juce::File& file, juce::AudioBuffer<float>& dest)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader (wav.createReaderFor(file.createInputStream().release(), true));
+        if (reader == nullptr)
+            return false;
+
+        dest.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&dest, 0, dest.getNumSamples(), 0, true, true);
+    }
+
+    //==============================================================================
+    /** Largest deviation from 0 dB of the magnitude response of the summed
+        bands, from their impulse response.
+    */
+    inline double measureSumFlatness (const Setup& setup)
+    {
+        constexpr int fftOrder = 16;
+        constexpr int fftSize = 1 << fftOrder;
+
+        // The impulse comes after a short silence, so any parameter glides have settled.
+        const auto offset = static_cast<int>(0.1 * sampleRate);
+        juce::AudioBuffer<float> impulse (numChannels, offset + fftSize);
+        impulse.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+            impulse.setSample(ch, offset, 1.f);
+
+        const auto response = render(setup, impulse).audio;
+
+        std::vector<float> fftData (static_cast<size_t>(fftSize) * 2, 0.f);
+        std::copy_n(response.getReadPointer(0, offset), fftSize, fftData.begin());
+
+        juce::dsp::FFT fft (fftOrder);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        // 20 Hz to 20 kHz; outside that the linear-phase kernels are allowed to roll off.
+        const auto firstBin = static_cast<int>(20.0 * fftSize / sampleRate);
+        const auto lastBin = static_cast<int>(20000.0 * fftSize / sampleRate);
+
+        auto worst = 0.0;
+        for (int bin = firstBin; bin <= lastBin; ++bin)
+            worst = juce::jmax(worst, std::abs(static_cast<double>(juce::Decibels::gainToDecibels(fftData[static_cast<size_t>(bin)], -400.f))));
+
+        return worst;
+    }
+
+    //==============================================================================
+    class Report
+    {
+    public:
+        void add (const juce::String& check, const juce::String& signal, double measured, double tolerance,
+                  const juce::String& unit, double speed = 0.0)
+        {
+            const auto passed = measured <= tolerance;
+            failures += passed ? 0 : 1;
+
+            lines.add(check + "," + signal + "," + juce::String(measured, 2) + "," + juce::String(tolerance, 2) + ","
+                      + unit + "," + (speed > 0.0 ? juce::String(speed, 1) : juce::String()) + ","
+                      + (passed ? "pass" : "FAIL"));
+            std::cerr << lines[lines.size() - 1] << std::endl;
+        }
+
+        void addError (const juce::String& check, const juce::String& signal, const juce::String& error)
+        {
+            ++failures;
+            lines.add(check + "," + signal + ",,,,," + "FAIL (" + error + ")");
+            std::cerr << lines[lines.size() - 1] << std::endl;
+        }
+
+        juce::String toString() const
+        {
+            return "check,signal,measured,tolerance,unit,x_realtime,result\n" + lines.joinIntoString("\n") + "\n";
+        }
+
+        int getNumFailures() const noexcept { return failures; }
+
+    private:
+        juce::StringArray lines;
+        int failures = 0;
+    };
+
+    /** Tools/Benchmark/Golden in the source tree: found from this file's path
+        when the compiler recorded an absolute one, otherwise relative to the
+        working directory, which then has to be the repository root.
+    */
+    inline juce::File getDefaultGoldenDirectory()
+    {
+        const juce::String sourceFile (__FILE__);
+        if (juce::File::isAbsolutePath(sourceFile))
+            return juce::File(sourceFile).getParentDirectory().getSiblingFile("Golden");
+
+        return juce::File::getCurrentWorkingDirectory().getChildFile("Tools/Benchmark/Golden");
+    }
+
+    /** Renders the goldens from the original signal path into dir, replacing any that are there. */
+    inline int writeGoldenFiles (const juce::File& dir)
+    {
+        if (! dir.createDirectory())
+        {
+            std::cerr << "Could not create " << dir.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        const auto signals = makeTestSignals();
+        for (auto& goldenCase : getGoldenCases())
+        {
+            for (auto& signal : signals)
+            {
+                const auto file = dir.getChildFile(goldenCase.name + "_" + signal.name + ".wav");
+                if (! writeGolden(file, renderBaseline(goldenCase.settings, signal.audio)))
+                {
+                    std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+                    return 1;
+                }
+
+                std::cerr << "Wrote " << file.getFileName() << std::endl;
+            }
+        }
+
+        return 0;
+    }
+
+    /** Compares against the golden renders in dir, then checks the paths that
+        have to agree with each other and the flatness of the crossover sum.
+    */
+    inline Report runChecks (const juce::File& dir)
+    {
+        Report report;
+        const auto signals = makeTestSignals();
+
+        // The original plugin had three bands, so other band counts have nothing to compare with.
+        if (SimpleMBCompAudioProcessor::numBands != 3)
+        {
+            report.addError("golden", "all", "built with " + juce::String(SimpleMBCompAudioProcessor::numBands) + " bands");
+            return report;
+        }
+
+        for (auto& goldenCase : getGoldenCases())
+        {
+            for (auto& signal : signals)
+            {
+                const auto file = dir.getChildFile(goldenCase.name + "_" + signal.name + ".wav");
+                juce::AudioBuffer<float> golden;
+
+                if (! readGolden(file, golden))
+                {
+                    report.addError(goldenCase.name, signal.name, "missing " + file.getFileName());
+                    continue;
+                }
+
+                const auto result = render(goldenCase.settings, signal.audio);
+                if (golden.getNumChannels() != result.audio.getNumChannels() || golden.getNumSamples() != result.audio.getNumSamples())
+                {
+                    report.addError(goldenCase.name, signal.name, "golden file has a different length");
+                    continue;
+                }
+
+                report.add(goldenCase.name, signal.name, compare(result.audio, golden).peakDecibels,
+                           getToleranceDecibels(goldenCase.stage), "dBFS", result.getSpeed());
+
+                // The stored file has to be what the original path renders with this
+                // JUCE version, or the comparison above would be against the wrong thing.
+                report.add("baseline-" + goldenCase.name, signal.name,
+                           compare(renderBaseline(goldenCase.settings, signal.audio), golden).peakDecibels, -120.0, "dBFS");
+            }
+        }
+
+        // Paths that must agree with the default one: block size, precision
+        // and the gain math approximations.
+        struct Equivalence
+        {
+            juce::String name;
+            RenderOptions options;
+            double toleranceDecibels;
+        };
+
+        RenderOptions smallBlocks;
+        smallBlocks.blockSize = 37;
+        RenderOptions doublePrecision;
+        doublePrecision.useDouble = true;
+        RenderOptions referenceMath;
+        referenceMath.referenceGainMath = true;
+
+        const Equivalence equivalences[] {
+            { "block-size-37", smallBlocks, -120.0 },
+            { "double-precision", doublePrecision, getToleranceDecibels(Stage::compressor) },
+            { "reference-gain-math", referenceMath, getToleranceDecibels(Stage::compressor) }
+        };
+
+        const auto compressed = compressHard();
+
+        for (auto& signal : signals)
+        {
+            const auto reference = render(compressed, signal.audio);
+
+            for (auto& equivalence : equivalences)
+            {
+                const auto result = render(compressed, signal.audio, equivalence.options);
+                report.add(equivalence.name, signal.name, compare(result.audio, reference.audio).peakDecibels,
+                           equivalence.toleranceDecibels, "dBFS", result.getSpeed());
+            }
+        }
+
+        // With every band bypassed the bands have to sum to a flat magnitude:
+        // an allpass for the Linkwitz-Riley tree, a delay for the linear-phase one.
+        const Setup iirSum = [](auto& p) { setAllBands(p, Params::BandParam::Bypassed, 1.f); };
+        const Setup linearPhaseSum = [](auto& p)
+        {
+            setAllBands(p, Params::BandParam::Bypassed, 1.f);
+            setParameter(p, Params::GetParams().at(Params::Names::Crossover_Mode), 1.f);
+        };
+
+        report.add("flat-sum", "impulse", measureSumFlatness(iirSum), 0.01, "dB");
+        report.add("flat-sum-linear-phase", "impulse", measureSumFlatness(linearPhaseSum), 0.1, "dB");
+
+        return report;
+    }
+}
@@ -0,0 +1,652 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 3:47:56am
+    Author:  agent
+
+    processBlock micro-benchmark. Sweeps block size, sample rate, channel
+    count, oversampling factor and band solo/mute/bypass states and writes one CSV or JSON record
+    per case, so results can be diffed between releases. With --golden-check
+    it runs the accuracy checks in GoldenRender.h instead.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "GoldenRender.h"
+
+namespace
+{
+    enum class BandState
+    {
+        Active,
+        Bypassed,
+        Muted,
+        Soloed
+    };
+
+    constexpr auto numBands = SimpleMBCompAudioProcessor::numBands;
+    using BandStates = std::array<BandState, numBands>;
+
+    juce::String toString (BandState state)
+    {
+        switch (state)
+        {
+            case BandState::Active:   return "active";
+            case BandState::Bypassed: return "bypassed";
+            case BandState::Muted:    return "muted";
+            case BandState::Soloed:   return "soloed";
+        }
+
+        return {};
+    }
+
+    juce::String toString (const BandStates& states)
+    {
+        juce::StringArray names;
+        for (auto state : states)
+            names.add(toString(state));
+
+        return names.joinIntoString("/");
+    }
+
+    struct BenchCase
+    {
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        int oversampling = 1;
+        BandStates bands {};
+    };
+
+    struct BenchResult
+    {
+        BenchCase config;
+        double nsPerSample = 0.0;
+        double bestNsPerSample = 0.0;
+        double worstNsPerSample = 0.0;
+        double samplesPerSecond = 0.0;
+    };
+
+    //==============================================================================
+    void setParam (SimpleMBCompAudioProcessor& processor, const juce::String& name, float value)
+    {
+        auto* param = processor.apvts.getParameter(name);
+        jassert(param != nullptr);
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    void applyBandStates (SimpleMBCompAudioProcessor& processor, const BandStates& states)
+    {
+        using namespace Params;
+
+        for (size_t i = 0; i < states.size(); ++i)
+        {
+            auto name = [i](BandParam p) { return GetBandParamName<numBands>(p, i); };
+
+            setParam(processor, name(BandParam::Bypassed), states[i] == BandState::Bypassed ? 1.f : 0.f);
+            setParam(processor, name(BandParam::Mute), states[i] == BandState::Muted ? 1.f : 0.f);
+            setParam(processor, name(BandParam::Solo), states[i] == BandState::Soloed ? 1.f : 0.f);
+
+            // Low thresholds so the compressors actually do gain reduction.
+            setParam(processor, name(BandParam::Threshold), -30.f);
+        }
+    }
+
+    // Moves every crossover between two points inside its range.
+    void setCrossovers (SimpleMBCompAudioProcessor& processor, bool upper)
+    {
+        using namespace Params;
+
+        for (size_t split = 0; split < numBands - 1; ++split)
+        {
+            auto range = GetCrossoverRange<numBands>(split);
+            auto position = upper ? 0.75f : 0.25f;
+            setParam(processor, GetCrossoverParamName<numBands>(split),
+                     range.minimum * std::pow(range.maximum / range.minimum, position));
+        }
+    }
+
+    std::vector<BandStates> getBandScenarios (bool allCombinations)
+    {
+        std::vector<BandStates> scenarios;
+
+        if (allCombinations)
+        {
+            auto numCombinations = 1;
+            for (size_t i = 0; i < numBands; ++i)
+                numCombinations *= 4;
+
+            for (int combination = 0; combination < numCombinations; ++combination)
+            {
+                BandStates states;
+                auto c = combination;
+                for (auto& state : states)
+                {
+                    state = static_cast<BandState>(c % 4);
+                    c /= 4;
+                }
+                scenarios.push_back(states);
+            }
+
+            return scenarios;
+        }
+
+        auto allBands = [](BandState state)
+        {
+            BandStates states;
+            states.fill(state);
+            return states;
+        };
+
+        scenarios.push_back(allBands(BandState::Active));
+        scenarios.push_back(allBands(BandState::Bypassed));
+        scenarios.push_back(allBands(BandState::Muted));
+
+        for (size_t i = 0; i < numBands; ++i)
+        {
+            auto soloed = allBands(BandState::Active);
+            soloed[i] = BandState::Soloed;
+            scenarios.push_back(soloed);
+        }
+
+        auto alternating = [&allBands](BandState state)
+        {
+            auto states = allBands(BandState::Active);
+            for (size_t i = 0; i < numBands; i += 2)
+                states[i] = state;
+            return states;
+        };
+
+        scenarios.push_back(alternating(BandState::Muted));
+        scenarios.push_back(alternating(BandState::Bypassed));
+        return scenarios;
+    }
+
+    //==============================================================================
+    template <typename SampleType>
+    BenchResult runCase (SimpleMBCompAudioProcessor& processor,
+                         const juce::AudioBuffer<float>& source,
+                         const BenchCase& config,
+                         double secondsPerCase,
+                         bool sweepCrossovers)
+    {
+        processor.releaseResources();
+        processor.setPlayConfigDetails(config.numChannels, config.numChannels, config.sampleRate, config.blockSize);
+        applyBandStates(processor, config.bands);
+        setCrossovers(processor, false);
+        setParam(processor, Params::GetParams().at(Params::Names::Oversampling),
+                 static_cast<float>(juce::roundToInt(std::log2(config.oversampling))));
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+        processor.reset();
+
+        juce::AudioBuffer<SampleType> buffer (config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        const auto sourceLength = source.getNumSamples() - config.blockSize;
+        const auto numBlocks = juce::jmax(8, static_cast<int>(secondsPerCase * config.sampleRate / config.blockSize));
+        const auto numWarmupBlocks = juce::jmax(2, numBlocks / 10);
+        const auto blocksPerRetarget = juce::jmax(1, static_cast<int>(config.sampleRate / 20.0 / config.blockSize));
+
+        juce::int64 totalTicks = 0;
+        juce::int64 bestTicks = std::numeric_limits<juce::int64>::max();
+        juce::int64 worstTicks = 0;
+        int readPos = 0;
+
+        for (int b = -numWarmupBlocks; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < config.numChannels; ++ch)
+            {
+                auto* src = source.getReadPointer(ch % source.getNumChannels(), readPos);
+                std::copy(src, src + config.blockSize, buffer.getWritePointer(ch));
+            }
+
+            readPos = (readPos + config.blockSize) % sourceLength;
+
+            // A new target every 50 ms keeps the crossovers permanently sweeping.
+            if (sweepCrossovers && b % blocksPerRetarget == 0)
+                setCrossovers(processor, ((b / blocksPerRetarget) & 1) != 0);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            if (b >= 0)
+            {
+                totalTicks += elapsed;
+                bestTicks = juce::jmin(bestTicks, elapsed);
+                worstTicks = juce::jmax(worstTicks, elapsed);
+            }
+        }
+
+        const auto ticksToNs = 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        const auto totalSamples = static_cast<double>(numBlocks) * config.blockSize;
+
+        BenchResult result;
+        result.config = config;
+        result.nsPerSample = static_cast<double>(totalTicks) * ticksToNs / totalSamples;
+        result.bestNsPerSample = static_cast<double>(bestTicks) * ticksToNs / config.blockSize;
+        result.worstNsPerSample = static_cast<double>(worstTicks) * ticksToNs / config.blockSize;
+        result.samplesPerSecond = result.nsPerSample > 0.0 ? 1.0e9 / result.nsPerSample : 0.0;
+        return result;
+    }
+
+    juce::String toCsvHeader()
+    {
+        return "block_size,sample_rate,channels,oversampling,bands,ns_per_sample,ns_per_channel_sample,best_ns_per_sample,worst_ns_per_sample,samples_per_sec";
+    }
+
+    juce::String toCsv (const BenchResult& r)
+    {
+        return juce::String(r.config.blockSize) + ","
+             + juce::String(r.config.sampleRate, 0) + ","
+             + juce::String(r.config.numChannels) + ","
+             + juce::String(r.config.oversampling) + ","
+             + toString(r.config.bands) + ","
+             + juce::String(r.nsPerSample, 3) + ","
+             + juce::String(r.nsPerSample / r.config.numChannels, 3) + ","
+             + juce::String(r.bestNsPerSample, 3) + ","
+             + juce::String(r.worstNsPerSample, 3) + ","
+             + juce::String(r.samplesPerSecond, 0);
+    }
+
+    juce::var toJson (const BenchResult& r)
+    {
+        auto* obj = new juce::DynamicObject();
+        obj->setProperty("block_size", r.config.blockSize);
+        obj->setProperty("sample_rate", r.config.sampleRate);
+        obj->setProperty("channels", r.config.numChannels);
+        obj->setProperty("oversampling", r.config.oversampling);
+        obj->setProperty("bands", toString(r.config.bands));
+        obj->setProperty("ns_per_sample", r.nsPerSample);
+        obj->setProperty("ns_per_channel_sample", r.nsPerSample / r.config.numChannels);
+        obj->setProperty("best_ns_per_sample", r.bestNsPerSample);
+        obj->setProperty("worst_ns_per_sample", r.worstNsPerSample);
+        obj->setProperty("samples_per_sec", r.samplesPerSecond);
+        return juce::var(obj);
+    }
+
+    /** Times parsing a bank of numPresets random presets; the bank is built in memory first. */
+    int runPresetBankBenchmark (SimpleMBCompAudioProcessor& processor, int numPresets)
+    {
+        auto& presets = processor.getPresetManager();
+        juce::Random random (0x5eed);
+
+        std::vector<ParameterSnapshot> bank;
+        for (int i = 0; i < numPresets; ++i)
+        {
+            auto preset = presets.capture("Preset " + juce::String(i + 1));
+            for (auto& value : preset.values)
+                value = random.nextFloat();
+
+            bank.push_back(std::move(preset));
+        }
+
+        juce::MemoryBlock data;
+        {
+            juce::MemoryOutputStream out (data, false);
+            PresetFormat::write(out, presets.getParameterIDs(), bank);
+        }
+
+        constexpr int numRuns = 50;
+        auto bestTicks = std::numeric_limits<juce::int64>::max();
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            const auto ok = presets.loadBank(data.getData(), data.getSize());
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            if (! ok || presets.getNumPresets() != numPresets)
+            {
+                std::cerr << "Bank did not load" << std::endl;
+                return 1;
+            }
+
+            bestTicks = juce::jmin(bestTicks, elapsed);
+        }
+
+        const auto ms = static_cast<double>(bestTicks) * 1000.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        std::cout << "presets,bytes,best_load_ms\n"
+                  << numPresets << "," << data.getSize() << "," << juce::String(ms, 3) << std::endl;
+        return 0;
+    }
+
+    /** Best time per sample of the compressor's gain computer over a slowly
+        moving envelope that crosses the threshold, as in real use.
+    */
+    template <typename SampleType>
+    double timeGainComputer (SampleType kneeDecibels, bool useReferenceMath)
+    {
+        constexpr int numSamples = 4096;
+        constexpr int numRuns = 200;
+
+        LinkedCompressor<SampleType> compressor;
+        compressor.prepare({ 48000.0, static_cast<juce::uint32>(numSamples), 1 });
+        compressor.setThreshold(SampleType(-20));
+        compressor.setRatio(SampleType(4));
+        compressor.setKnee(kneeDecibels);
+        compressor.setUseReferenceGainMath(useReferenceMath);
+
+        juce::Random random (0x5eed);
+        juce::HeapBlock<SampleType> levels (numSamples), data (numSamples);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto decibels = -30.0 + 25.0 * std::sin(juce::MathConstants<double>::twoPi * i / 2000.0) + random.nextDouble() - 0.5;
+            levels[i] = static_cast<SampleType>(juce::Decibels::decibelsToGain(decibels));
+        }
+
+        auto bestTicks = std::numeric_limits<juce::int64>::max();
+        for (int run = 0; run < numRuns; ++run)
+        {
+            std::copy(levels.get(), levels.get() + numSamples, data.get());
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            compressor.computeGain(data.get(), static_cast<size_t>(numSamples));
+            bestTicks = juce::jmin(bestTicks, juce::Time::getHighResolutionTicks() - start);
+        }
+
+        return static_cast<double>(bestTicks) * 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / numSamples;
+    }
+
+    /** Times the fast and the reference gain math against each other. */
+    int runGainMathBenchmark()
+    {
+        std::cout << "precision,knee_db,reference_ns_per_sample,fast_ns_per_sample,speedup\n";
+
+        auto print = [] (const char* precision, double knee, double reference, double fast)
+        {
+            std::cout << precision << "," << knee << "," << juce::String(reference, 3) << "," << juce::String(fast, 3)
+                      << "," << juce::String(reference / fast, 2) << "\n";
+        };
+
+        for (auto knee : { 0.0, 6.0 })
+        {
+            print("float", knee, timeGainComputer<float>(static_cast<float>(knee), true), timeGainComputer<float>(static_cast<float>(knee), false));
+            print("double", knee, timeGainComputer<double>(knee, true), timeGainComputer<double>(knee, false));
+        }
+
+        std::cout << std::flush;
+        return 0;
+    }
+
+    /** The value given to option as either "--option value" or "--option=value",
+        or an empty string if there is none. juce::ArgumentList only reads the
+        second form for long options.
+    */
+    juce::String getOptionValue (const juce::ArgumentList& args, juce::StringRef option)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+
+            if (arg.text.startsWith(juce::String(option) + "="))
+                return arg.text.fromFirstOccurrenceOf("=", false, false);
+
+            if (arg == option)
+                return i + 1 < args.size() && ! args[i + 1].isOption() ? args[i + 1].text : juce::String();
+        }
+
+        return {};
+    }
+
+    /** A file or directory given after option, or fallback when there is none. */
+    juce::File getFileOption (const juce::ArgumentList& args, juce::StringRef option, const juce::File& fallback)
+    {
+        const auto value = getOptionValue(args, option);
+        return value.isEmpty() ? fallback : juce::File::getCurrentWorkingDirectory().getChildFile(value.unquoted());
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: SimpleMBCompBench [options]\n"
+                     "  --json                write JSON instead of CSV\n"
+                     "  --out <file>          write results to a file instead of stdout\n"
+                     "  --seconds <s>         audio seconds rendered per case (default: 0.5)\n"
+                     "  --all-states          sweep every solo/mute/bypass combination\n"
+                     "  --quick               only 64/512/4096 samples at 48k\n"
+                     "  --block-sizes <list>  comma separated block sizes, e.g. 64 (default: 16 to 4096)\n"
+                     "  --parallel-bands      run the bands on the worker pool for large blocks\n"
+                     "  --sweep-crossovers    keep moving the crossover frequencies\n"
+                     "  --stepped-crossovers  jump to new crossover frequencies at each ramp step\n"
+                     "  --linear-phase        use the linear-phase crossover; with --quick --block-sizes 64,\n"
+                     "                        worst_ns_per_sample shows how evenly its work is spread\n"
+                     "  --meters              measure levels as if the editor were open\n"
+                     "  --stereo-link <mode>  off, max or average (default: off)\n"
+                     "  --channels <list>     comma separated channel counts, e.g. 2,6,12 (default: 1,2)\n"
+                     "  --lookahead <ms>      compressor lookahead, 0 to 10 (default: 0)\n"
+                     "  --oversampling <list> comma separated factors out of 1,2,4,8 (default: 1)\n"
+                     "  --oversampling-quality <q>  low-latency, high-quality or linear-phase (default: low-latency)\n"
+                     "  --reference-math      exact compressor gain math instead of the fast approximation\n"
+                     "  --gain-math           only time the compressor's fast gain math against the reference\n"
+                     "  --double              process in double precision\n"
+                     "  --silence             feed digital silence; processing stops once the tails\n"
+                     "                        have decayed (about a second), so use --seconds 5 or more\n"
+                     "  --preset-bank <n>     only time loading a bank of n presets (e.g. 200)\n"
+                     "  --golden-write [dir]  render the golden files from the original signal path into\n"
+                     "                        dir (default: Tools/Benchmark/Golden)\n"
+                     "  --golden-check [dir]  compare with the golden files in dir (default: Tools/Benchmark/Golden),\n"
+                     "                        check equivalent paths and the flat crossover sum;\n"
+                     "                        exits with 1 on any failure\n";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    if (args.containsOption("--golden-write"))
+        return Golden::writeGoldenFiles(getFileOption(args, "--golden-write", Golden::getDefaultGoldenDirectory()));
+
+    if (args.containsOption("--golden-check"))
+    {
+        const auto report = Golden::runChecks(getFileOption(args, "--golden-check", Golden::getDefaultGoldenDirectory()));
+        std::cout << report.toString();
+        std::cout << (report.getNumFailures() == 0 ? "All checks passed" : juce::String(report.getNumFailures()) + " checks FAILED") << std::endl;
+        return report.getNumFailures() == 0 ? 0 : 1;
+    }
+
+    if (args.containsOption("--gain-math"))
+        return runGainMathBenchmark();
+
+    if (args.containsOption("--preset-bank"))
+    {
+        SimpleMBCompAudioProcessor processor;
+        return runPresetBankBenchmark(processor, juce::jlimit(1, 10000, getOptionValue(args, "--preset-bank").getIntValue()));
+    }
+
+    const auto asJson = args.containsOption("--json");
+    const auto quick = args.containsOption("--quick");
+    const auto secondsPerCase = args.containsOption("--seconds")
+                              ? juce::jmax(0.01, getOptionValue(args, "--seconds").getDoubleValue())
+                              : 0.5;
+
+    std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    std::vector<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    std::vector<int> channelCounts { 1, 2 };
+    std::vector<int> oversamplingFactors { 1 };
+
+    if (args.containsOption("--channels"))
+    {
+        channelCounts.clear();
+        for (auto& token : juce::StringArray::fromTokens(getOptionValue(args, "--channels"), ",", {}))
+        {
+            const auto count = token.getIntValue();
+            if (count >= 1 && count <= 64)
+                channelCounts.push_back(count);
+        }
+
+        if (channelCounts.empty())
+        {
+            std::cerr << "--channels takes channel counts from 1 to 64" << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--oversampling"))
+    {
+        oversamplingFactors.clear();
+        for (auto& token : juce::StringArray::fromTokens(getOptionValue(args, "--oversampling"), ",", {}))
+        {
+            const auto factor = token.getIntValue();
+            if (factor >= 1 && factor <= 8 && juce::isPowerOfTwo(factor))
+                oversamplingFactors.push_back(factor);
+        }
+
+        if (oversamplingFactors.empty())
+        {
+            std::cerr << "--oversampling takes factors out of 1,2,4,8" << std::endl;
+            return 1;
+        }
+    }
+
+    if (quick)
+    {
+        blockSizes = { 64, 512, 4096 };
+        sampleRates = { 48000.0 };
+    }
+
+    if (args.containsOption("--block-sizes"))
+    {
+        blockSizes.clear();
+        for (auto& token : juce::StringArray::fromTokens(getOptionValue(args, "--block-sizes"), ",", {}))
+        {
+            const auto size = token.getIntValue();
+            if (size >= 1 && size <= 8192)
+                blockSizes.push_back(size);
+        }
+
+        if (blockSizes.empty())
+        {
+            std::cerr << "--block-sizes takes block sizes from 1 to 8192" << std::endl;
+            return 1;
+        }
+    }
+
+    const auto scenarios = getBandScenarios(args.containsOption("--all-states"));
+
+    // Ten seconds of stereo noise at a musical level (or of silence), looped through every case.
+    juce::AudioBuffer<float> source (2, 480000);
+    source.clear();
+    juce::Random random (0x5eed);
+    for (int ch = 0; ch < source.getNumChannels() && ! args.containsOption("--silence"); ++ch)
+    {
+        auto* data = source.getWritePointer(ch);
+        for (int i = 0; i < source.getNumSamples(); ++i)
+            data[i] = (random.nextFloat() * 2.f - 1.f) * 0.5f;
+    }
+
+    SimpleMBCompAudioProcessor processor;
+    processor.setParallelBandMode(args.containsOption("--parallel-bands")
+                                  ? SimpleMBCompAudioProcessor::ParallelBandMode::Always
+                                  : SimpleMBCompAudioProcessor::ParallelBandMode::Off);
+    processor.setCrossoverSweepMode(args.containsOption("--stepped-crossovers")
+                                    ? CrossoverSweepMode::Stepped
+                                    : CrossoverSweepMode::Smoothed);
+
+    const auto sweepCrossovers = args.containsOption("--sweep-crossovers");
+    processor.setMeteringEnabled(args.containsOption("--meters"));
+    processor.setUseReferenceGainMath(args.containsOption("--reference-math"));
+
+    const auto useDouble = args.containsOption("--double");
+    processor.setProcessingPrecision(useDouble ? juce::AudioProcessor::doublePrecision
+                                               : juce::AudioProcessor::singlePrecision);
+
+    const auto stereoLink = juce::StringArray { "off", "max", "average" }
+                                .indexOf(getOptionValue(args, "--stereo-link"), true);
+    setParam(processor, Params::GetParams().at(Params::Names::Stereo_Link), static_cast<float>(juce::jmax(0, stereoLink)));
+    setParam(processor, Params::GetParams().at(Params::Names::Lookahead), getOptionValue(args, "--lookahead").getFloatValue());
+    setParam(processor, Params::GetParams().at(Params::Names::Crossover_Mode), args.containsOption("--linear-phase") ? 1.f : 0.f);
+
+    const auto oversamplingQuality = juce::StringArray { "low-latency", "high-quality", "linear-phase" }
+                                         .indexOf(getOptionValue(args, "--oversampling-quality"), true);
+    setParam(processor, Params::GetParams().at(Params::Names::Oversampling_Quality), static_cast<float>(juce::jmax(0, oversamplingQuality)));
+
+    juce::Array<juce::var> jsonResults;
+    juce::StringArray csvLines;
+    csvLines.add(toCsvHeader());
+
+    for (auto numChannels : channelCounts)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                for (auto oversampling : oversamplingFactors)
+                {
+                    for (auto& bands : scenarios)
+                    {
+                        BenchCase config;
+                        config.blockSize = blockSize;
+                        config.sampleRate = sampleRate;
+                        config.numChannels = numChannels;
+                        config.oversampling = oversampling;
+                        config.bands = bands;
+
+                        auto result = useDouble ? runCase<double>(processor, source, config, secondsPerCase, sweepCrossovers)
+                                                : runCase<float>(processor, source, config, secondsPerCase, sweepCrossovers);
+
+                        if (asJson)
+                            jsonResults.add(toJson(result));
+                        else
+                            csvLines.add(toCsv(result));
+
+                        std::cerr << toCsv(result) << std::endl;
+
+                       #if SIMPLEMBCOMP_PROFILE
+                        // Per block, over this case only: prepareToPlay resets the histograms.
+                        std::cerr << processor.getStageProfile().toString() << std::endl;
+                       #endif
+                    }
+                }
+            }
+        }
+    }
+
+    juce::String output;
+    if (asJson)
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("plugin", JucePlugin_Name);
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("results", jsonResults);
+        output = juce::JSON::toString(juce::var(root));
+    }
+    else
+    {
+        output = csvLines.joinIntoString("\n") + "\n";
+    }
+
+    if (args.containsOption("--out"))
+    {
+        const auto outFile = getFileOption(args, "--out", {});
+        if (outFile == juce::File())
+        {
+            std::cerr << "--out takes a file name" << std::endl;
+            return 1;
+        }
+
+        if (! outFile.replaceWithText(output))
+        {
+            std::cerr << "Could not write " << outFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << output;
+    }
+
+    return 0;
+}
@@ -0,0 +1,371 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 3:47:09am
+    Author:  agent
+
+    Headless batch renderer: streams audio files through
+    SimpleMBCompAudioProcessor on a pool of workers, one processor per worker.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::MemoryBlock state;
+        juce::File outputDir;
+        juce::String suffix { "_mbc" };
+        int blockSize = 8192;
+        int numWorkers = juce::SystemStats::getNumCpus();
+        bool referenceGainMath = false;
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+    };
+
+    juce::CriticalSection printLock;
+
+    void print (const juce::String& text)
+    {
+        const juce::ScopedLock sl(printLock);
+        std::cout << text << std::endl;
+    }
+
+    juce::File getOutputFileFor (const juce::File& input, const RenderSettings& settings)
+    {
+        auto dir = settings.outputDir == juce::File() ? input.getParentDirectory() : settings.outputDir;
+        return dir.getChildFile(input.getFileNameWithoutExtension() + settings.suffix + input.getFileExtension());
+    }
+
+    bool configureProcessor (SimpleMBCompAudioProcessor& processor, int numChannels)
+    {
+        // Only the main buses change; the sidechain stays as it is (disabled).
+        auto layout = processor.getBusesLayout();
+        layout.getChannelSet(true, 0) = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        layout.getChannelSet(false, 0) = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+        if (! processor.checkBusesLayoutSupported(layout))
+            return false;
+
+        return processor.setBusesLayout(layout);
+    }
+
+    RenderResult renderFile (SimpleMBCompAudioProcessor& processor,
+                             juce::AudioFormatManager& formatManager,
+                             const juce::File& input,
+                             const RenderSettings& settings)
+    {
+        RenderResult result;
+
+        // An empty --suffix without --out, or --out naming the input's own
+        // folder, would have the output replace the input.
+        auto outputFile = getOutputFileFor(input, settings);
+        if (outputFile == input || outputFile.getLinkedTarget() == input.getLinkedTarget())
+        {
+            result.error = "output would overwrite the input";
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor(input));
+        if (reader == nullptr)
+        {
+            result.error = "unreadable input";
+            return result;
+        }
+
+        const auto numChannels = static_cast<int>(reader->numChannels);
+        const auto sampleRate = reader->sampleRate;
+        const auto length = reader->lengthInSamples;
+
+        processor.releaseResources();
+        if (! configureProcessor(processor, numChannels))
+        {
+            result.error = "unsupported channel count " + juce::String(numChannels);
+            return result;
+        }
+
+        auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+        if (format == nullptr)
+        {
+            result.error = "no writer for " + outputFile.getFileExtension();
+            return result;
+        }
+
+        outputFile.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream (outputFile.createOutputStream());
+        if (stream == nullptr)
+        {
+            result.error = "cannot create " + outputFile.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor(stream.get(),
+                                                                                 sampleRate,
+                                                                                 static_cast<unsigned int>(numChannels),
+                                                                                 static_cast<int>(reader->bitsPerSample),
+                                                                                 reader->metadataValues,
+                                                                                 0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot write " + outputFile.getFullPathName();
+            return result;
+        }
+        stream.release();
+
+        processor.setNonRealtime(true);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+        processor.reset();
+
+        // Run the processor past the end of the file by its latency and drop
+        // the same amount from the start, so the output lines up with the input.
+        const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+        juce::AudioBuffer<float> buffer (numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        for (juce::int64 pos = 0; pos < length + latency; pos += settings.blockSize)
+        {
+            const auto numSamples = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, length + latency - pos));
+
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            reader->read(&buffer, 0, numSamples, pos, true, true);
+
+            processor.processBlock(buffer, midi);
+            midi.clear();
+
+            const auto outStart = pos - latency;
+            const auto skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, -outStart));
+            const auto numToWrite = static_cast<int>(juce::jmin<juce::int64>(numSamples - skip, length - juce::jmax<juce::int64>(outStart, 0)));
+
+            if (numToWrite > 0 && ! writer->writeFromAudioSampleBuffer(buffer, skip, numToWrite))
+            {
+                result.error = "write failed";
+                return result;
+            }
+        }
+
+        processor.releaseResources();
+
+        result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        result.audioSeconds = static_cast<double>(length) / sampleRate;
+        result.ok = true;
+        return result;
+    }
+
+    //==============================================================================
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker (SimpleMBCompAudioProcessor& p,
+                      const juce::Array<juce::File>& filesToRender,
+                      std::atomic<int>& next,
+                      const RenderSettings& s,
+                      juce::Array<RenderResult>& resultSlots)
+            : juce::ThreadPoolJob("render"), processor(p), files(filesToRender),
+              nextFile(next), settings(s), results(resultSlots)
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        JobStatus runJob() override
+        {
+            for (auto index = nextFile++; index < files.size(); index = nextFile++)
+            {
+                if (shouldExit())
+                    break;
+
+                auto result = renderFile(processor, formatManager, files.getReference(index), settings);
+                results.getReference(index) = result;
+
+                if (result.ok)
+                    print(files[index].getFileName() + ": "
+                          + juce::String(result.audioSeconds / juce::jmax(result.wallSeconds, 1.0e-9), 1) + "x realtime");
+                else
+                    print(files[index].getFileName() + ": FAILED (" + result.error + ")");
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        SimpleMBCompAudioProcessor& processor;
+        juce::AudioFormatManager formatManager;
+        const juce::Array<juce::File>& files;
+        std::atomic<int>& nextFile;
+        const RenderSettings& settings;
+        juce::Array<RenderResult>& results;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: SimpleMBCompRender [options] <input files or folders...>\n"
+                     "  --state <file>    plugin state saved by getStateInformation\n"
+                     "  --out <folder>    output folder (default: next to each input)\n"
+                     "  --suffix <text>   appended to output names (default: _mbc)\n"
+                     "  --jobs <n>        number of workers (default: number of CPUs)\n"
+                     "  --block <n>       processing block size (default: 8192)\n"
+                     "  --reference-math  exact compressor gain math instead of the fast approximation\n";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The APVTS needs a message manager, and parameter state is loaded on this thread.
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::ArgumentList args (argc, argv);
+    RenderSettings settings;
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    juce::Array<juce::File> files;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--state" && hasValue)
+        {
+            auto stateFile = args[++i].resolveAsFile();
+            if (! stateFile.loadFileAsData(settings.state))
+            {
+                std::cerr << "Could not read " << stateFile.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--out" && hasValue)
+        {
+            settings.outputDir = args[++i].resolveAsFile();
+            settings.outputDir.createDirectory();
+        }
+        else if (arg == "--suffix" && hasValue)
+        {
+            settings.suffix = args[++i].text;
+        }
+        else if (arg == "--jobs" && hasValue)
+        {
+            settings.numWorkers = juce::jmax(1, args[++i].text.getIntValue());
+        }
+        else if (arg == "--block" && hasValue)
+        {
+            settings.blockSize = juce::jmax(16, args[++i].text.getIntValue());
+        }
+        else if (arg == "--reference-math")
+        {
+            settings.referenceGainMath = true;
+        }
+        else if (arg.isOption())
+        {
+            std::cerr << "Unknown option " << arg.text << std::endl;
+            printUsage();
+            return 1;
+        }
+        else
+        {
+            auto file = arg.resolveAsFile();
+            if (file.isDirectory())
+            {
+                for (auto& f : file.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff"))
+                    files.add(f);
+            }
+            else if (file.existsAsFile())
+            {
+                files.add(file);
+            }
+            else
+            {
+                std::cerr << "Skipping missing input " << arg.text << std::endl;
+            }
+        }
+    }
+
+    if (files.isEmpty())
+    {
+        std::cerr << "No input files." << std::endl;
+        return 1;
+    }
+
+    const auto numWorkers = juce::jmin(settings.numWorkers, files.size());
+
+    // One processor per worker, constructed and given its state here on the
+    // message thread so that replaceState's listeners run where they expect to.
+    // Per-band threads only pay off when the file workers leave cores idle,
+    // e.g. when rendering a handful of long files on a big machine.
+    const auto bandMode = numWorkers * 3 <= juce::SystemStats::getNumCpus()
+                        ? SimpleMBCompAudioProcessor::ParallelBandMode::OfflineOnly
+                        : SimpleMBCompAudioProcessor::ParallelBandMode::Off;
+
+    juce::OwnedArray<SimpleMBCompAudioProcessor> processors;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* processor = processors.add(new SimpleMBCompAudioProcessor());
+        processor->setParallelBandMode(bandMode);
+        processor->setUseReferenceGainMath(settings.referenceGainMath);
+        if (settings.state.getSize() > 0)
+            processor->setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+    }
+
+    juce::Array<RenderResult> results;
+    results.resize(files.size());
+    std::atomic<int> nextFile { 0 };
+
+   #if SIMPLEMBCOMP_RT_AUDIT && JUCE_LINUX
+    // A clean report only means something if a deliberate allocation shows up.
+    if (! RealtimeAudit::catchesAllocations())
+    {
+        std::cerr << "RT audit: an AudioBuffer::setSize on the audio thread went uncounted" << std::endl;
+        return 1;
+    }
+   #endif
+
+    RealtimeAudit::resetReport();
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool (numWorkers);
+        for (auto* processor : processors)
+            pool.addJob(new RenderWorker(*processor, files, nextFile, settings, results), true);
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(50);
+    }
+
+    const auto wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    double audioSeconds = 0.0;
+    int failures = 0;
+    for (auto& r : results)
+    {
+        audioSeconds += r.audioSeconds;
+        failures += r.ok ? 0 : 1;
+    }
+
+    std::cout << "Rendered " << (files.size() - failures) << "/" << files.size() << " files, "
+              << juce::String(audioSeconds, 1) << "s of audio in " << juce::String(wallSeconds, 2) << "s on "
+              << numWorkers << " workers: "
+              << juce::String(audioSeconds / juce::jmax(wallSeconds, 1.0e-9), 1) << "x realtime" << std::endl;
+
+   #if SIMPLEMBCOMP_RT_AUDIT
+    std::cout << RealtimeAudit::getReport().toString() << std::endl;
+   #endif
+
+    return failures == 0 ? 0 : 1;
+}